@@ -17,6 +17,8 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 // [CLI11:public_includes:end]
@@ -78,6 +80,20 @@ Option *default_flag_modifiers(Option *opt) {
 }  // namespace detail
 
 class Option_group;
+
+/// The argument buffer of App::parse(argc, argv, context), kept between the parses of a program parsing many command
+/// lines with the same App: the parse then reuses the capacity of the previous ones instead of allocating again
+class ParseContext {
+    friend App;
+
+    /// The arguments in reverse order, emptied by the parse
+    std::vector<std::string> args_{};
+
+  public:
+    /// Reserve the buffer for a number of arguments
+    void reserve(std::size_t count) { args_.reserve(count); }
+};
+
 /// Creates a command line program, with very few defaults.
 /** To use, create a new `Program()` instance with `argc`, `argv`, and a help description. The templated
  *  add_option methods make it easy to prepare options. Remember to call `.start` before starting your
@@ -143,6 +159,13 @@ class App {
     /// The list of options, stored locally
     std::vector<Option_p> options_{};
 
+    /// Position in options_ of the options by the key of each of their names, see _option_key
+    using option_index_t = std::unordered_multimap<std::string, std::size_t>;
+
+    /// Index of the option names, updated by every change of the options or of their names so a lookup only reads
+    /// it, also from the threads reading config files
+    option_index_t option_index_{};
+
     ///@}
     /// @name Help
     ///@{
@@ -207,6 +230,20 @@ class App {
     /// Storage for subcommand list
     std::vector<App_p> subcommands_{};
 
+    /// The folded key of a subcommand name, with the app holding the name
+    using subcommand_key_t = std::pair<std::string, App *>;
+
+    /// Subcommands by the folded keys of their names and aliases, and of the ones of the subcommands of the
+    /// nameless ones, see _subcommand_keys; each entry holds the subcommand of this app, and the app holding the
+    /// name, that subcommand or one of the subcommands under it
+    using subcommand_index_t =
+        std::unordered_multimap<std::string, std::pair<App *, App *>, detail::folded_hash, detail::folded_equal>;
+
+    /// Index of the subcommand names for the conflict checks and the dispatch of the arguments, updated by every
+    /// change of the subcommands so a lookup only reads it, also from the threads reading config files;
+    /// the keys of a former name are only dropped when the index is rebuilt
+    subcommand_index_t subcommand_index_{};
+
     /// If true, the program name is not case sensitive INHERITABLE
     bool ignore_case_{false};
 
@@ -279,6 +316,15 @@ class App {
     /// This is the formatter for help printing. Default provided. INHERITABLE (same pointer)
     std::shared_ptr<Config> config_formatter_{new ConfigTOML()};
 
+    /// Setters of the configurable options by key path, built on the first config file and kept until the
+    /// options or the subcommands change
+    std::unique_ptr<ConfigDecoder> config_decoder_{};
+
+#ifdef CLI11_CPP17
+    /// Configuration compiled into the program, applied after the config files
+    const StaticConfig *static_config_{nullptr};
+#endif
+
     ///@}
 
     /// Special private constructor for subcommand
@@ -469,6 +515,15 @@ class App {
         return this;
     }
 
+#ifdef CLI11_CPP17
+    /// Apply a configuration compiled into the program (main app only), as a config file read after the ones of the
+    /// config option: the command line and the config files take precedence. The tables must outlive the app
+    App *config_defaults(const StaticConfig &config) {
+        static_config_ = &config;
+        return this;
+    }
+#endif
+
     /// Check to see if this subcommand was parsed, true only if received on command line.
     CLI11_NODISCARD bool parsed() const { return parsed_ > 0; }
 
@@ -522,6 +577,7 @@ class App {
         opt->type_size(detail::type_count_min<ConvertTo>::value, (std::max)(Tcount, XCcount));
         opt->expected(detail::expected_count<ConvertTo>::value);
         opt->run_callback_for_default();
+        opt->config_value_setter_ = detail::config_value_setter<AssignTo, ConvertTo>(variable);
         return opt;
     }
 
@@ -669,6 +725,9 @@ class App {
 #endif
 
     /// Set a configuration ini file option, or clear it if no name passed
+    ///
+    /// A file may also be a directory or a glob on the last component (conf.d/*.yaml), the files are then
+    /// parsed concurrently and applied in the order of their names, the last one having the precedence
     Option *set_config(std::string option_name = "",
                        std::string default_filename = "",
                        const std::string &help_message = "Read an ini file",
@@ -830,6 +889,10 @@ class App {
     /// This must be called after the options are in but before the rest of the program.
     void parse(int argc, const char *const *argv);
 
+    /// Parses the command line through the buffer of a context, after a first parse with the same context the
+    /// arguments shorter than the small string buffer are parsed without any allocation
+    void parse(int argc, const char *const *argv, ParseContext &context);
+
     /// Parse a single string as if it contained command line arguments.
     /// This function splits the string into arguments then calls parse(std::vector<std::string> &)
     /// the function takes an optional boolean argument specifying if the programName is included in the string to
@@ -1187,6 +1250,44 @@ class App {
     /// Read and process a configuration file (main app only)
     void _process_config_file();
 
+#ifdef CLI11_CPP17
+    /// Process the configuration compiled into the program, if any (main app only)
+    void _process_static_config();
+#endif
+
+    /// The full keys of the config items already applied by the files of higher precedence
+    using config_keys_t = std::unordered_set<std::string>;
+
+    /// Parse the files of a configuration directory concurrently, then apply them in order, the last file first
+    void _process_config_directory(const std::vector<std::string> &config_files,
+                                   const std::function<bool(const std::string &)> &load_section,
+                                   config_keys_t *applied);
+
+    /// Check if the items of a top level section of a configuration file can be used, a config formatter
+    /// may skip the sections of the subcommands not used on the command line
+    CLI11_NODISCARD bool _config_section_needed(const std::string &name) const;
+
+#ifdef CLI11_CPP17
+    /// The items of a configuration file, with the parent paths shared by the items
+    using config_items_t = CompactConfig;
+#else
+    /// The items of a configuration file
+    using config_items_t = std::vector<ConfigItem>;
+#endif
+
+    /// Get the decoder table of the options of this app and of its subcommands, built when needed
+    const ConfigDecoder &_config_decoder();
+
+    /// Add the setters of the options of an app to the decoder table, prefix is the key path of the app
+    void _add_config_setters(ConfigDecoder &decoder, const std::string &prefix) const;
+
+    /// Drop the decoder tables of this app and of its parents, the options changed
+    void _reset_config_decoder();
+
+    /// Read the items of a configuration file with the config formatter
+    CLI11_NODISCARD config_items_t
+    _read_config_file(const std::string &name, const std::function<bool(const std::string &)> &load_section) const;
+
     /// Get envname options if not yet passed. Runs on *all* subcommands.
     void _process_env();
 
@@ -1227,7 +1328,15 @@ class App {
     ///
     /// If this has more than one dot.separated.name, go into the subcommand matching it
     /// Returns true if it managed to find the option, if false you'll need to remove the arg manually.
-    void _parse_config(const std::vector<ConfigItem> &args);
+    ///
+    /// With applied, the items of a key already in it are skipped before any lookup, the keys of the other
+    /// items are added: several files then fill each key once, from the file applied first
+    void _parse_config(const std::vector<ConfigItem> &args, config_keys_t *applied = nullptr);
+
+#ifdef CLI11_CPP17
+    /// Parse the compact items of a config file, the subcommand of each parent path is only looked up once
+    void _parse_config(const CompactConfig &args, config_keys_t *applied = nullptr);
+#endif
 
     /// Fill in a single config option
     bool _parse_single_config(const ConfigItem &item, std::size_t level = 0);
@@ -1252,6 +1361,10 @@ class App {
     CLI11_NODISCARD App *
     _find_subcommand(const std::string &subc_name, bool ignore_disabled, bool ignore_used) const noexcept;
 
+    /// Same as _find_subcommand, going through all the subcommands in order
+    CLI11_NODISCARD App *
+    _scan_subcommands(const std::string &subc_name, bool ignore_disabled, bool ignore_used) const noexcept;
+
     /// Parse a subcommand, modify args and continue
     ///
     /// Unlike the others, this one will always allow fallthrough
@@ -1262,6 +1375,31 @@ class App {
     /// return true if the argument was processed or false if nothing was done
     bool _parse_arg(std::vector<std::string> &args, detail::Classifier current_type);
 
+    /// The index key of an option name of a kind: 's'hort, 'l'ong, 'p'ositional or 'e'nvironment. The case, and
+    /// the underscores of the long and positional names, are folded whatever the settings of the option
+    static std::string _option_key(char kind, const std::string &name);
+
+    /// Add the names of the option at a position of options_ to the index
+    void _index_option(std::size_t position);
+
+    /// Build again the option name index of this app, the positions of its options changed
+    void _rebuild_option_index();
+
+    /// Position of the first option holding a name of a kind, if before position, else before; the candidates
+    /// of the index are checked with the settings of each option
+    CLI11_NODISCARD std::size_t _find_option(char kind, const std::string &name, std::size_t before) const;
+
+    /// Position of the first option matching a name as check_name does, or the number of options
+    CLI11_NODISCARD std::size_t _find_option(const std::string &option_name) const;
+
+    /// Position of the first option other than opt sharing one of its names, as Option::operator== tells, or the
+    /// number of options
+    CLI11_NODISCARD std::size_t _find_matching_option(const Option &opt) const;
+
+    /// Replace the previous environment name of an option in the index of the app holding it, this app or one of
+    /// its subcommands; false if the option was not found
+    bool _reindex_envname(const Option *opt, const std::string &previous);
+
     /// Trigger the pre_parse callback if needed
     void _trigger_pre_parse(std::size_t remaining_args);
 
@@ -1271,8 +1409,25 @@ class App {
     /// Helper function to run through all possible comparisons of subcommand names to check there is no overlap
     CLI11_NODISCARD const std::string &_compare_subcommand_names(const App &subcom, const App &base) const;
 
+    /// Compare the names of an app with the ones of a single subcommand of the base of _compare_subcommand_names
+    CLI11_NODISCARD const std::string &_compare_subcommand_name(const App &subcom, const App &subc) const;
+
+    /// Add the folded keys of the name and aliases of an app, held by holder, and the ones of its subcommands if
+    /// it is nameless
+    static void _subcommand_keys(const App &app, App *holder, std::vector<subcommand_key_t> &keys);
+
+    /// Add keys of a subcommand of this app to the index of this app, and to the ones of its parents while the app
+    /// holding them is nameless
+    void _index_subcommand_keys(App *subcom, const std::vector<subcommand_key_t> &keys);
+
+    /// Build again the subcommand name indexes of this app and of its parents
+    void _rebuild_subcommand_index();
+
+    /// check_name without allocation, for the subcommand lookups
+    CLI11_NODISCARD bool _check_name(const std::string &name_to_check) const noexcept;
+
     /// Helper function to place extra values in the most appropriate position
-    void _move_to_missing(detail::Classifier val_type, const std::string &val);
+    void _move_to_missing(detail::Classifier val_type, std::string val);
 
   public:
     /// function that could be used by subclasses of App to shift options around into subcommands
@@ -11,11 +11,32 @@
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <streambuf>
 #include <string>
 #include <utility>
 #include <vector>
 // [CLI11:public_includes:set]
 
+// [CLI11:config_hpp_mmap:verbatim]
+
+// Memory mapping of the configuration files, the stream is used where it is not available
+#if !defined CLI11_HAS_MMAP
+#if defined(_WIN32) || defined(__wasi__)
+#define CLI11_HAS_MMAP 0
+#else
+#define CLI11_HAS_MMAP 1
+#endif
+#endif
+
+#if CLI11_HAS_MMAP > 0
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// [CLI11:config_hpp_mmap:end]
+
 #include "App.hpp"
 #include "ConfigFwd.hpp"
 #include "StringTools.hpp"
@@ -38,6 +59,35 @@ std::vector<std::string> generate_parents(const std::string &section, std::strin
 
 /// assuming non default segments do a check on the close and open of the segments in a configItem structure
 void checkParentSegments(std::vector<ConfigItem> &output, const std::string &currentSection, char parentSeparator);
+
+/// Read only view on the whole content of a file, memory mapped when possible
+class MappedFile {
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    /// Map a regular file, return false if it has to be read as a stream instead (pipes, devices, empty files)
+    bool open(const std::string &name);
+
+    CLI11_NODISCARD const char *data() const { return data_; }
+    CLI11_NODISCARD std::size_t size() const { return size_; }
+
+  private:
+    const char *data_{nullptr};
+    std::size_t size_{0};
+};
+
+/// Input stream buffer reading directly from a contiguous buffer, without copying it
+class BufferStreambuf : public std::streambuf {
+  public:
+    BufferStreambuf(const char *data, std::size_t size);
+
+  protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
 }  // namespace detail
 
 // [CLI11:config_hpp:end]
@@ -8,20 +8,42 @@
 
 // [CLI11:public_includes:set]
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 // [CLI11:public_includes:end]
 
 #include "Error.hpp"
 #include "StringTools.hpp"
+#include "TypeTools.hpp"
+
+#ifdef CLI11_CPP17
+// [CLI11:public_includes:set]
+#include <string_view>
+// [CLI11:public_includes:end]
+#endif
 
 namespace CLI {
 // [CLI11:config_fwd_hpp:verbatim]
 
 class App;
 
+/// The value of a single scalar input, when the config format already knows its type
+struct ConfigValue {
+    /// The kind of value held, none when only the input string is known
+    enum class value_type : std::uint8_t { none, integer, real, boolean, string };
+
+    value_type type{value_type::none};
+    std::int64_t integer{0};
+    double real{0.0};
+    bool boolean{false};
+};
+
 /// Holds values to load into Options
 struct ConfigItem {
     /// This is the list of parents
@@ -33,6 +55,9 @@ struct ConfigItem {
     /// Listing of inputs
     std::vector<std::string> inputs{};
 
+    /// The typed value of the input when there is only one
+    ConfigValue value{};
+
     /// The list of parents and name joined by "."
     CLI11_NODISCARD std::string fullname() const {
         std::vector<std::string> tmp = parents;
@@ -41,6 +66,281 @@ struct ConfigItem {
     }
 };
 
+namespace detail {
+
+/// Set an integral variable from a config value, false when it is not an integer or does not fit
+template <typename T,
+          enable_if_t<classify_object<T>::value == object_category::integral_value ||
+                          classify_object<T>::value == object_category::unsigned_integral,
+                      detail::enabler> = detail::dummy>
+bool config_value_assign(const ConfigValue &value, const std::string & /*input*/, T &output) {
+    if(value.type != ConfigValue::value_type::integer || (std::is_unsigned<T>::value && value.integer < 0)) {
+        return false;
+    }
+    auto converted = static_cast<T>(value.integer);
+    if(static_cast<std::int64_t>(converted) != value.integer) {
+        return false;
+    }
+    output = converted;
+    return true;
+}
+
+/// Set a double from a config value, the rounding is the one of lexical_cast
+template <typename T, enable_if_t<std::is_same<T, double>::value, detail::enabler> = detail::dummy>
+bool config_value_assign(const ConfigValue &value, const std::string & /*input*/, T &output) {
+    if(value.type == ConfigValue::value_type::real) {
+        output = value.real;
+        return true;
+    }
+    if(value.type == ConfigValue::value_type::integer) {
+        output = static_cast<double>(value.integer);
+        return true;
+    }
+    return false;
+}
+
+/// Set a boolean from a config value
+template <typename T,
+          enable_if_t<classify_object<T>::value == object_category::boolean_value, detail::enabler> = detail::dummy>
+bool config_value_assign(const ConfigValue &value, const std::string & /*input*/, T &output) {
+    if(value.type != ConfigValue::value_type::boolean) {
+        return false;
+    }
+    output = value.boolean;
+    return true;
+}
+
+/// Set a string from the input, whatever the type of the value
+template <typename T, enable_if_t<std::is_same<T, std::string>::value, detail::enabler> = detail::dummy>
+bool config_value_assign(const ConfigValue &value, const std::string &input, T &output) {
+    if(value.type == ConfigValue::value_type::none) {
+        return false;
+    }
+    output = input;
+    return true;
+}
+
+/// Check if a variable can be set from a config value
+template <typename T> struct config_value_assignable {
+    static constexpr bool value = classify_object<T>::value == object_category::integral_value ||
+                                  classify_object<T>::value == object_category::unsigned_integral ||
+                                  classify_object<T>::value == object_category::boolean_value ||
+                                  std::is_same<T, double>::value || std::is_same<T, std::string>::value;
+};
+
+/// Make the function setting a variable from a config value
+template <typename AssignTo,
+          typename ConvertTo,
+          enable_if_t<std::is_same<AssignTo, ConvertTo>::value && config_value_assignable<AssignTo>::value,
+                      detail::enabler> = detail::dummy>
+std::function<bool(const ConfigValue &, const std::string &)> config_value_setter(AssignTo &variable) {
+    return [&variable](const ConfigValue &value, const std::string &input) {
+        return config_value_assign(value, input, variable);
+    };
+}
+
+/// No direct assignment for the other variables, their inputs are converted by the option callback
+template <typename AssignTo,
+          typename ConvertTo,
+          enable_if_t<!std::is_same<AssignTo, ConvertTo>::value || !config_value_assignable<AssignTo>::value,
+                      detail::enabler> = detail::dummy>
+std::function<bool(const ConfigValue &, const std::string &)> config_value_setter(AssignTo & /*variable*/) {
+    return {};
+}
+
+}  // namespace detail
+
+/// Table from the key paths of a configuration to the functions setting their options, built by an App
+class ConfigDecoder {
+  public:
+    /// Set an option from a scalar, false when the item must be parsed as a ConfigItem
+    using setter_t = std::function<bool(const ConfigValue &, const std::string &)>;
+
+    /// Append a name to a key, the parents and the name of an item are separated by '\0'
+    static void append(std::string &key, const std::string &name) {
+        if(!key.empty()) {
+            key.push_back('\0');
+        }
+        key.append(name);
+    }
+
+    /// Add the setter of a key, the first one added for a key is kept
+    void add(std::string key, setter_t setter) { setters_.emplace(std::move(key), std::move(setter)); }
+
+    /// Set the option of a key from a scalar, false when the key is unknown or its setter refused the value
+    bool assign(const std::string &key, const ConfigValue &value, const std::string &input) const {
+        auto found = setters_.find(key);
+        return found != setters_.end() && found->second(value, input);
+    }
+
+    /// The number of keys
+    CLI11_NODISCARD std::size_t size() const { return setters_.size(); }
+
+  private:
+    std::unordered_map<std::string, setter_t> setters_{};
+};
+
+#ifdef CLI11_CPP17
+/// The items of a configuration compiled into a program as constexpr tables, with the layout of CompactConfig
+/// The headers written by cli11-yaml-embed define one from a YAML file
+struct StaticConfig {
+    /// A section, the parent is the index of its section in the table plus one, 0 for the top level
+    struct Section {
+        std::uint32_t parent;
+        std::string_view name;
+    };
+    /// An item, its section is numbered as the parent of a section and its inputs are a range of the input table
+    struct Item {
+        std::uint32_t section;
+        std::string_view name;
+        std::uint32_t first_input;
+        std::uint32_t input_count;
+        ConfigValue value;
+    };
+
+    const Section *sections;
+    std::size_t section_count;
+    const Item *items;
+    std::size_t item_count;
+    const std::string_view *inputs;
+    std::size_t input_count;
+};
+
+/// Holds the items of a configuration in a flat layout: the parent paths are interned once and referenced by id,
+/// the names and inputs are views into an arena owned by the container
+class CompactConfig {
+  public:
+    /// Identifier of an interned parent path, a child always has a larger id than its parent
+    using path_id = std::uint32_t;
+
+    /// The id of the empty path, the top level items
+    static constexpr path_id root{0};
+
+    /// A config item, its inputs are a range of the input list of the container
+    struct Item {
+        /// The interned path of the parents
+        path_id path{root};
+
+        /// This is the name
+        std::string_view name{};
+
+        /// Index of the first input
+        std::uint32_t first_input{0};
+
+        /// Number of inputs
+        std::uint32_t input_count{0};
+
+        /// The typed value of the input when there is only one
+        ConfigValue value{};
+    };
+
+    CompactConfig();
+    /// Build the compact form of a list of items
+    explicit CompactConfig(const std::vector<ConfigItem> &items);
+
+    /// Build the compact form of compiled items, the names and the inputs are views of the static tables
+    explicit CompactConfig(const StaticConfig &config);
+
+    // the views point into the arena, so only moving keeps them valid
+    CompactConfig(const CompactConfig &) = delete;
+    CompactConfig &operator=(const CompactConfig &) = delete;
+    CompactConfig(CompactConfig &&) noexcept = default;
+    CompactConfig &operator=(CompactConfig &&) noexcept = default;
+    ~CompactConfig() = default;
+
+    /// Intern the path of a child section, the same id is returned for the same parent and name
+    path_id path(path_id parent, std::string_view name);
+
+    /// Intern a list of parents
+    path_id path(const std::vector<std::string> &parents);
+
+    /// Copy a string into the arena
+    std::string_view store(std::string_view text);
+
+    /// Add an item without inputs at the end
+    void add(path_id parent, std::string_view name);
+
+    /// Add an item
+    void add(const ConfigItem &item);
+
+    /// Add an input to the last item
+    void add_input(std::string_view input);
+
+    /// Add a copy of an item under another path, its name and inputs are not copied
+    void repeat(path_id parent, const Item &item);
+
+    /// Set the typed value of the last item
+    void set_value(const ConfigValue &value) { items_.back().value = value; }
+
+    /// Move the items of another container at the end, its arena is taken over so its strings are not copied
+    void append(CompactConfig &&other);
+
+    /// Remove the last item
+    void pop_back();
+
+    /// The items in order
+    CLI11_NODISCARD const std::vector<Item> &items() const { return items_; }
+    /// The last item
+    CLI11_NODISCARD const Item &back() const { return items_.back(); }
+    /// The number of items
+    CLI11_NODISCARD std::size_t size() const { return items_.size(); }
+    /// Check if there are no items
+    CLI11_NODISCARD bool empty() const { return items_.empty(); }
+
+    /// The inputs of an item
+    CLI11_NODISCARD const std::string_view *inputs(const Item &item) const {
+        return inputs_.data() + item.first_input;
+    }
+
+    /// The number of interned paths, the root included
+    CLI11_NODISCARD std::size_t path_count() const { return paths_.size(); }
+    /// The path holding a path, the root is its own parent
+    CLI11_NODISCARD path_id parent(path_id path) const { return paths_[path].parent; }
+    /// The last name of a path
+    CLI11_NODISCARD std::string_view name(path_id path) const { return paths_[path].name; }
+    /// The number of names of a path
+    CLI11_NODISCARD std::size_t depth(path_id path) const { return paths_[path].depth; }
+
+    /// Fill the names of a path, from the top level down
+    void parents(path_id path, std::vector<std::string> &output) const;
+
+    /// Fill a ConfigItem with the name, the inputs and the value of an item, the parents are left unchanged
+    void assign(const Item &item, ConfigItem &output) const;
+
+    /// Convert back to a list of items
+    CLI11_NODISCARD std::vector<ConfigItem> to_items() const;
+
+  private:
+    struct Path {
+        path_id parent;
+        std::string_view name;
+        std::uint32_t depth;
+    };
+
+    struct Key {
+        path_id parent;
+        std::string_view name;
+        bool operator==(const Key &other) const { return parent == other.parent && name == other.name; }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &key) const {
+            return std::hash<std::string_view>()(key.name) * 31U + key.parent;
+        }
+    };
+
+    /// Chunks of the arena, a chunk is never moved so the views stay valid
+    std::vector<std::unique_ptr<char[]>> chunks_{};
+    char *cursor_{nullptr};
+    std::size_t remaining_{0};
+
+    std::vector<Path> paths_{};
+    std::unordered_map<Key, path_id, KeyHash> index_{};
+    std::vector<Item> items_{};
+    std::vector<std::string_view> inputs_{};
+};
+#endif
+
 /// This class provides a converter for configuration files.
 class Config {
   protected:
@@ -64,15 +364,57 @@ class Config {
         throw ConversionError::TooManyInputsFlag(item.fullname());
     }
 
+    /// Convert a configuration held in a contiguous buffer into an app, by default read through a stream
+    virtual std::vector<ConfigItem> from_buffer(const char *data, std::size_t size) const;
+
     /// Parse a config file, throw an error (ParseError:ConfigParseError or FileError) on failure
-    CLI11_NODISCARD std::vector<ConfigItem> from_file(const std::string &name) const {
-        std::ifstream input{name};
-        if(!input.good())
-            throw FileError::Missing(name);
+    /// Regular files are memory mapped and given to from_buffer, other files are read by from_config
+    CLI11_NODISCARD virtual std::vector<ConfigItem> from_file(const std::string &name) const;
 
-        return from_config(input);
+    /// Parse a config file, the top level sections rejected by load_section are not used by the caller
+    /// so a format may skip them, by default the whole file is parsed
+    CLI11_NODISCARD virtual std::vector<ConfigItem>
+    from_file(const std::string &name, const std::function<bool(const std::string &)> &load_section) const {
+        (void)load_section;
+        return from_file(name);
     }
 
+    /// Parse a config file straight into the options of an app: the scalars accepted by the decoder are assigned
+    /// through it and the other items are given to item in order. Return false when the format has no such mode,
+    /// the items of the file are then parsed by the app
+    virtual bool decode_file(const std::string &name,
+                             const ConfigDecoder &decoder,
+                             const std::function<void(const ConfigItem &)> &item,
+                             const std::function<bool(const std::string &)> &load_section) const {
+        (void)name;
+        (void)decoder;
+        (void)item;
+        (void)load_section;
+        return false;
+    }
+
+    /// True when decode_file reads the files, an App only builds the decoder of its options in this case
+    CLI11_NODISCARD virtual bool supports_decode() const { return false; }
+
+#ifdef CLI11_CPP17
+    /// Convert a configuration into the compact items, by default the items of from_config are converted
+    CLI11_NODISCARD virtual CompactConfig from_config_compact(std::istream &input) const {
+        return CompactConfig(from_config(input));
+    }
+
+    /// Parse a config file into the compact items, this is what an App reads when supports_compact is true
+    /// By default the items of from_file are converted
+    CLI11_NODISCARD virtual CompactConfig
+    from_file_compact(const std::string &name, const std::function<bool(const std::string &)> &load_section) const {
+        return CompactConfig(from_file(name, load_section));
+    }
+
+    /// True when from_file_compact gives the items of from_file, so an App may read the files through it
+    /// The built-in formats only return true for their own type: a derived class may override from_config or
+    /// from_file without knowing the compact path, its files are then read by from_file
+    CLI11_NODISCARD virtual bool supports_compact() const { return false; }
+#endif
+
     /// Virtual destructor
     virtual ~Config() = default;
 };
@@ -108,6 +450,20 @@ class ConfigBase : public Config {
     to_config(const App * /*app*/, bool default_also, bool write_description, std::string prefix) const override;
 
     std::vector<ConfigItem> from_config(std::istream &input) const override;
+
+#ifdef CLI11_CPP17
+    /// Build the compact items line by line, the list of ConfigItem is never created
+    CompactConfig from_config_compact(std::istream &input) const override;
+
+    /// Parse a config file into the compact items with from_config_compact
+    CompactConfig
+    from_file_compact(const std::string &name,
+                      const std::function<bool(const std::string &)> &load_section) const override;
+
+    /// True for a ConfigBase or a ConfigINI, not for a class derived from them
+    CLI11_NODISCARD bool supports_compact() const override;
+#endif
+
     /// Specify the configuration for comment characters
     ConfigBase *comment(char cchar) {
         commentChar = cchar;
@@ -164,6 +520,13 @@ class ConfigBase : public Config {
         configIndex = sectionIndex;
         return this;
     }
+
+  private:
+    /// Parse the lines of a configuration, flush is called after each line when it is set and may take the
+    /// leading items, only the last one can still be changed by the next line
+    void parse_lines(std::istream &input,
+                     std::vector<ConfigItem> &output,
+                     const std::function<void(std::vector<ConfigItem> &)> &flush) const;
 };
 
 /// the default Config is the TOML file format
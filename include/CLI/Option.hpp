@@ -17,6 +17,7 @@
 #include <vector>
 // [CLI11:public_includes:end]
 
+#include "ConfigFwd.hpp"
 #include "Error.hpp"
 #include "Macros.hpp"
 #include "Split.hpp"
@@ -306,6 +307,9 @@ class Option : public OptionBase<Option> {
     /// Options store a callback to do all the work
     callback_t callback_{};
 
+    /// Set the variable from the typed value of a config item, empty when the inputs must be converted
+    std::function<bool(const ConfigValue &, const std::string &)> config_value_setter_{};
+
     ///@}
     /// @name Parsing results
     ///@{
@@ -481,8 +485,15 @@ class Option : public OptionBase<Option> {
     bool remove_excludes(Option *opt);
 
     /// Sets environment variable to read if no option given
-    Option *envname(std::string name) {
+    ///
+    /// The template hides the fact that we don't have the definition of App yet.
+    template <typename T = App> Option *envname(std::string name) {
+        std::string previous = std::move(envname_);
         envname_ = std::move(name);
+        // the option may have been moved to a subcommand since
+        if(parent_ != nullptr) {
+            static_cast<T *>(parent_)->_reindex_envname(this, previous);
+        }
         return this;
     }
 
@@ -672,6 +683,13 @@ class Option : public OptionBase<Option> {
         if(current_option_state_ >= option_state::reduced || (results_.size() == 1 && validators_.empty())) {
             const results_t &res = (proc_results_.empty()) ? results_ : proc_results_;
             retval = detail::lexical_conversion<T, T>(res, output);
+        } else if(!results_.empty() && (validators_.empty() || current_option_state_ != option_state::parsing)) {
+            // no validator is left to change the values, they are converted in place unless the policy reduces them
+            const results_t &original =
+                (current_option_state_ == option_state::parsing || proc_results_.empty()) ? results_ : proc_results_;
+            results_t res;
+            _reduce_results(res, original);
+            retval = detail::lexical_conversion<T, T>(res.empty() ? original : res, output);
         } else {
             results_t res;
             if(results_.empty()) {
@@ -797,6 +815,10 @@ class Option : public OptionBase<Option> {
 
     /// Add a single result to the result set, taking into account delimiters
     int _add_result(std::string &&result, std::vector<std::string> &res) const;
+
+    /// Set the variable from the typed value of a config item instead of running the callback
+    /// Only done for a single result without validators, return false if the callback must still run
+    bool _assign_config_value(const ConfigValue &value);
 };
 
 // [CLI11:option_hpp:end]
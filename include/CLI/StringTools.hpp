@@ -184,6 +184,27 @@ inline std::string remove_underscore(std::string str) {
     return str;
 }
 
+/// Compare two names, with the underscores of each one removed and the case ignored as asked, without building
+/// the folded strings
+CLI11_INLINE bool equal_folded(const std::string &name,
+                               bool name_underscore,
+                               const std::string &other,
+                               bool other_underscore,
+                               bool ignore_case) noexcept;
+
+/// Hash of a name folded as to_lower(remove_underscore(name)), so a name is looked up in an index of folded names
+/// without building its folded string
+struct folded_hash {
+    CLI11_INLINE std::size_t operator()(const std::string &name) const noexcept;
+};
+
+/// Equality of two names folded as to_lower(remove_underscore(name))
+struct folded_equal {
+    bool operator()(const std::string &name, const std::string &other) const noexcept {
+        return equal_folded(name, true, other, true, true);
+    }
+};
+
 /// Find and replace a substring with another substring
 CLI11_INLINE std::string find_and_replace(std::string str, std::string from, std::string to);
 
@@ -196,7 +217,7 @@ CLI11_INLINE void remove_default_flag_values(std::string &flags);
 
 /// Check if a string is a member of a list of strings and optionally ignore case or ignore underscores
 CLI11_INLINE std::ptrdiff_t find_member(std::string name,
-                                        const std::vector<std::string> names,
+                                        const std::vector<std::string> &names,
                                         bool ignore_case = false,
                                         bool ignore_underscore = false);
 
@@ -59,6 +59,9 @@
 #else
 #include <sys/stat.h>
 #include <sys/types.h>
+#if !defined(_WIN32)
+#include <dirent.h>
+#endif
 #endif
 
 // [CLI11:validators_hpp_filesystem:end]
@@ -216,6 +219,15 @@ enum class path_type { nonexistent, file, directory };
 /// get the type of the path from a file name
 CLI11_INLINE path_type check_path(const char *file) noexcept;
 
+/// check if the last component of a path holds the wildcards * or ?
+CLI11_INLINE bool has_wildcards(const std::string &path);
+
+/// match a file name against a pattern with the wildcards * and ?
+CLI11_INLINE bool wildcard_match(const std::string &name, const std::string &pattern);
+
+/// List the regular files of a directory matching a pattern, sorted by name (hidden files only on an explicit '.')
+CLI11_INLINE std::vector<std::string> list_directory(const std::string &directory, const std::string &pattern = "*");
+
 /// Check for an existing file (returns error message if check fails)
 class ExistingFileValidator : public Validator {
   public:
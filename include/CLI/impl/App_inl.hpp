@@ -11,8 +11,12 @@
 
 // [CLI11:public_includes:set]
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <memory>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 // [CLI11:public_includes:end]
@@ -63,10 +67,14 @@ CLI11_INLINE App *App::name(std::string app_name) {
             name_ = oname;
             throw(OptionAlreadyAdded(app_name + " conflicts with existing subcommand names"));
         }
+        std::vector<subcommand_key_t> keys;
+        _subcommand_keys(*this, this, keys);
+        parent_->_index_subcommand_keys(this, keys);
     } else {
         name_ = app_name;
     }
     has_automatic_name_ = false;
+    _reset_config_decoder();
     return this;
 }
 
@@ -81,10 +89,11 @@ CLI11_INLINE App *App::alias(std::string app_name) {
             aliases_.pop_back();
             throw(OptionAlreadyAdded("alias already matches an existing subcommand: " + app_name));
         }
+        parent_->_index_subcommand_keys(this, {{detail::to_lower(detail::remove_underscore(app_name)), this}});
     } else {
         aliases_.push_back(app_name);
     }
-
+    _reset_config_decoder();
     return this;
 }
 
@@ -135,11 +144,12 @@ CLI11_INLINE Option *App::add_option(std::string option_name,
                                      std::function<std::string()> func) {
     Option myopt{option_name, option_description, option_callback, this};
 
-    if(std::find_if(std::begin(options_), std::end(options_), [&myopt](const Option_p &v) { return *v == myopt; }) ==
-       std::end(options_)) {
+    std::size_t match = _find_matching_option(myopt);
+    if(match == options_.size()) {
         options_.emplace_back();
         Option_p &option = options_.back();
         option.reset(new Option(option_name, option_description, option_callback, this));
+        _index_option(options_.size() - 1);
 
         // Set the default string capture function
         option->default_function(func);
@@ -155,17 +165,11 @@ CLI11_INLINE Option *App::add_option(std::string option_name,
         if(!defaulted && option->get_always_capture_default())
             option->capture_default_str();
 
+        _reset_config_decoder();
         return option.get();
     }
     // we know something matches now find what it is so we can produce more error information
-    for(auto &opt : options_) {
-        const auto &matchname = opt->matching_name(myopt);
-        if(!matchname.empty()) {
-            throw(OptionAlreadyAdded("added option matched existing option name: " + matchname));
-        }
-    }
-    // this line should not be reached the above loop should trigger the throw
-    throw(OptionAlreadyAdded("added option matched existing option name"));  // LCOV_EXCL_LINE
+    throw(OptionAlreadyAdded("added option matched existing option name: " + options_[match]->matching_name(myopt)));
 }
 
 CLI11_INLINE Option *App::set_help_flag(std::string flag_name, const std::string &help_description) {
@@ -332,6 +336,8 @@ CLI11_INLINE bool App::remove_option(Option *opt) {
         std::find_if(std::begin(options_), std::end(options_), [opt](const Option_p &v) { return v.get() == opt; });
     if(iterator != std::end(options_)) {
         options_.erase(iterator);
+        _rebuild_option_index();
+        _reset_config_decoder();
         return true;
     }
     return false;
@@ -364,6 +370,10 @@ CLI11_INLINE App *App::add_subcommand(CLI::App_p subcom) {
     }
     subcom->parent_ = this;
     subcommands_.push_back(std::move(subcom));
+    std::vector<subcommand_key_t> keys;
+    _subcommand_keys(*subcommands_.back(), subcommands_.back().get(), keys);
+    _index_subcommand_keys(subcommands_.back().get(), keys);
+    _reset_config_decoder();
     return subcommands_.back().get();
 }
 
@@ -378,6 +388,8 @@ CLI11_INLINE bool App::remove_subcommand(App *subcom) {
         std::begin(subcommands_), std::end(subcommands_), [subcom](const App_p &v) { return v.get() == subcom; });
     if(iterator != std::end(subcommands_)) {
         subcommands_.erase(iterator);
+        _rebuild_subcommand_index();
+        _reset_config_decoder();
         return true;
     }
     return false;
@@ -453,6 +465,7 @@ CLI11_INLINE void App::clear() {
     pre_parse_called_ = false;
 
     missing_.clear();
+    parse_order_.clear();
     parsed_subcommands_.clear();
     for(const Option_p &opt : options_) {
         opt->clear();
@@ -463,17 +476,27 @@ CLI11_INLINE void App::clear() {
 }
 
 CLI11_INLINE void App::parse(int argc, const char *const *argv) {
+    ParseContext context;
+    context.reserve(static_cast<std::size_t>(argc) - 1U);
+    parse(argc, argv, context);
+}
+
+CLI11_INLINE void App::parse(int argc, const char *const *argv, ParseContext &context) {
     // If the name is not set, read from command line
     if(name_.empty() || has_automatic_name_) {
         has_automatic_name_ = true;
         name_ = argv[0];
+        if(parent_ != nullptr) {
+            _rebuild_subcommand_index();
+        }
     }
 
-    std::vector<std::string> args;
-    args.reserve(static_cast<std::size_t>(argc) - 1U);
+    // the arguments left by an error are dropped, the capacity is kept
+    context.args_.clear();
     for(auto i = static_cast<std::size_t>(argc) - 1U; i > 0U; --i)
-        args.emplace_back(argv[i]);
-    parse(std::move(args));
+        context.args_.emplace_back(argv[i]);
+    // taken by reference, the buffer is not moved out of the context
+    parse(std::move(context.args_));
 }
 
 CLI11_INLINE void App::parse(std::string commandline, bool program_name_included) {
@@ -483,6 +506,9 @@ CLI11_INLINE void App::parse(std::string commandline, bool program_name_included
         if((name_.empty()) || (has_automatic_name_)) {
             has_automatic_name_ = true;
             name_ = nstr.first;
+            if(parent_ != nullptr) {
+                _rebuild_subcommand_index();
+            }
         }
         commandline = std::move(nstr.second);
     } else {
@@ -709,10 +735,9 @@ CLI11_INLINE std::vector<Option *> App::get_options(const std::function<bool(Opt
 }
 
 CLI11_INLINE Option *App::get_option_no_throw(std::string option_name) noexcept {
-    for(Option_p &opt : options_) {
-        if(opt->check_name(option_name)) {
-            return opt.get();
-        }
+    std::size_t position = _find_option(option_name);
+    if(position < options_.size()) {
+        return options_[position].get();
     }
     for(auto &subc : subcommands_) {
         // also check down into nameless subcommands
@@ -727,10 +752,9 @@ CLI11_INLINE Option *App::get_option_no_throw(std::string option_name) noexcept
 }
 
 CLI11_NODISCARD CLI11_INLINE const Option *App::get_option_no_throw(std::string option_name) const noexcept {
-    for(const Option_p &opt : options_) {
-        if(opt->check_name(option_name)) {
-            return opt.get();
-        }
+    std::size_t position = _find_option(option_name);
+    if(position < options_.size()) {
+        return options_[position].get();
     }
     for(const auto &subc : subcommands_) {
         // also check down into nameless subcommands
@@ -744,6 +768,123 @@ CLI11_NODISCARD CLI11_INLINE const Option *App::get_option_no_throw(std::string
     return nullptr;
 }
 
+CLI11_INLINE std::string App::_option_key(char kind, const std::string &name) {
+    std::string key(1, kind);
+    if(kind == 'e') {
+        // environment names are only matched exactly
+        key.append(name);
+    } else if(kind == 's') {
+        key.append(detail::to_lower(name));
+    } else {
+        key.append(detail::to_lower(detail::remove_underscore(name)));
+    }
+    return key;
+}
+
+CLI11_INLINE void App::_index_option(std::size_t position) {
+    const Option &opt = *options_[position];
+    for(const auto &sname : opt.snames_) {
+        option_index_.emplace(_option_key('s', sname), position);
+    }
+    for(const auto &lname : opt.lnames_) {
+        option_index_.emplace(_option_key('l', lname), position);
+    }
+    if(!opt.pname_.empty()) {
+        option_index_.emplace(_option_key('p', opt.pname_), position);
+    }
+    if(!opt.envname_.empty()) {
+        option_index_.emplace(_option_key('e', opt.envname_), position);
+    }
+}
+
+CLI11_INLINE void App::_rebuild_option_index() {
+    option_index_.clear();
+    for(std::size_t position = 0; position < options_.size(); ++position) {
+        _index_option(position);
+    }
+}
+
+CLI11_NODISCARD CLI11_INLINE std::size_t
+App::_find_option(char kind, const std::string &name, std::size_t before) const {
+    auto range = option_index_.equal_range(_option_key(kind, name));
+    for(auto it = range.first; it != range.second; ++it) {
+        if(it->second >= before) {
+            continue;
+        }
+        const Option &opt = *options_[it->second];
+        bool match = (kind == 'l')   ? opt.check_lname(name)
+                     : (kind == 's') ? opt.check_sname(name)
+                                     : opt.check_name(name);
+        if(match) {
+            before = it->second;
+        }
+    }
+    return before;
+}
+
+CLI11_NODISCARD CLI11_INLINE std::size_t App::_find_option(const std::string &option_name) const {
+    // same dispatch on the dashes as Option::check_name
+    if(option_name.length() > 2 && option_name[0] == '-' && option_name[1] == '-')
+        return _find_option('l', option_name.substr(2), options_.size());
+    if(option_name.length() > 1 && option_name.front() == '-')
+        return _find_option('s', option_name.substr(1), options_.size());
+    return _find_option('e', option_name, _find_option('p', option_name, options_.size()));
+}
+
+CLI11_NODISCARD CLI11_INLINE std::size_t App::_find_matching_option(const Option &opt) const {
+    // only the short and long names are compared, the candidates are the options sharing a folded one
+    std::size_t first = options_.size();
+    auto check = [this, &opt, &first](const std::string &key) {
+        auto range = option_index_.equal_range(key);
+        for(auto it = range.first; it != range.second; ++it) {
+            const Option *candidate = options_[it->second].get();
+            if(it->second < first && candidate != &opt && *candidate == opt) {
+                first = it->second;
+            }
+        }
+    };
+    for(const auto &sname : opt.snames_) {
+        check(_option_key('s', sname));
+    }
+    for(const auto &lname : opt.lnames_) {
+        check(_option_key('l', lname));
+    }
+    return first;
+}
+
+CLI11_INLINE bool App::_reindex_envname(const Option *opt, const std::string &previous) {
+    // any name of the option finds its position
+    std::string key = !opt->snames_.empty()   ? _option_key('s', opt->snames_.front())
+                      : !opt->lnames_.empty() ? _option_key('l', opt->lnames_.front())
+                                              : _option_key('p', opt->pname_);
+    auto range = option_index_.equal_range(key);
+    for(auto it = range.first; it != range.second; ++it) {
+        std::size_t position = it->second;
+        if(options_[position].get() != opt) {
+            continue;
+        }
+        if(!previous.empty()) {
+            auto env = option_index_.equal_range(_option_key('e', previous));
+            for(auto eit = env.first; eit != env.second; ++eit) {
+                if(eit->second == position) {
+                    option_index_.erase(eit);
+                    break;
+                }
+            }
+        }
+        if(!opt->envname_.empty()) {
+            option_index_.emplace(_option_key('e', opt->envname_), position);
+        }
+        return true;
+    }
+    for(App_p &subc : subcommands_) {
+        if(subc->_reindex_envname(opt, previous)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 CLI11_NODISCARD CLI11_INLINE std::string App::get_display_name(bool with_aliases) const {
     if(name_.empty()) {
         return std::string("[Option Group: ") + get_group() + "]";
@@ -761,27 +902,17 @@ CLI11_NODISCARD CLI11_INLINE std::string App::get_display_name(bool with_aliases
 }
 
 CLI11_NODISCARD CLI11_INLINE bool App::check_name(std::string name_to_check) const {
-    std::string local_name = name_;
-    if(ignore_underscore_) {
-        local_name = detail::remove_underscore(name_);
-        name_to_check = detail::remove_underscore(name_to_check);
-    }
-    if(ignore_case_) {
-        local_name = detail::to_lower(name_);
-        name_to_check = detail::to_lower(name_to_check);
-    }
+    return _check_name(name_to_check);
+}
 
-    if(local_name == name_to_check) {
+CLI11_NODISCARD CLI11_INLINE bool App::_check_name(const std::string &name_to_check) const noexcept {
+    // with ignore_case the underscores of the name itself are kept, as they always were
+    bool name_underscore = ignore_underscore_ && !ignore_case_;
+    if(detail::equal_folded(name_, name_underscore, name_to_check, ignore_underscore_, ignore_case_)) {
         return true;
     }
-    for(auto les : aliases_) {  // NOLINT(performance-for-range-copy)
-        if(ignore_underscore_) {
-            les = detail::remove_underscore(les);
-        }
-        if(ignore_case_) {
-            les = detail::to_lower(les);
-        }
-        if(les == name_to_check) {
+    for(const auto &les : aliases_) {
+        if(detail::equal_folded(les, ignore_underscore_, name_to_check, ignore_underscore_, ignore_case_)) {
             return true;
         }
     }
@@ -888,9 +1019,11 @@ CLI11_INLINE void App::_configure() {
     } else if(default_startup == startup_mode::disabled) {
         disabled_ = true;
     }
+    bool renamed = false;
     for(const App_p &app : subcommands_) {
-        if(app->has_automatic_name_) {
+        if(app->has_automatic_name_ && !app->name_.empty()) {
             app->name_.clear();
+            renamed = true;
         }
         if(app->name_.empty()) {
             app->fallthrough_ = false;  // make sure fallthrough_ is false to prevent infinite loop
@@ -900,6 +1033,10 @@ CLI11_INLINE void App::_configure() {
         app->parent_ = this;
         app->_configure();
     }
+    if(renamed) {
+        // the subcommands of a subcommand now nameless are found from this app
+        _rebuild_subcommand_index();
+    }
 }
 
 CLI11_INLINE void App::run_callback(bool final_mode, bool suppress_final_callback) {
@@ -909,7 +1046,8 @@ CLI11_INLINE void App::run_callback(bool final_mode, bool suppress_final_callbac
         parse_complete_callback_();
     }
     // run the callbacks for the received subcommands
-    for(App *subc : get_subcommands()) {
+    for(std::size_t i = 0; i < parsed_subcommands_.size(); ++i) {
+        App *subc = parsed_subcommands_[i];
         if(subc->parent_ == this) {
             subc->run_callback(true, suppress_final_callback);
         }
@@ -978,13 +1116,51 @@ CLI11_INLINE void App::_process_config_file() {
             }
             return;
         }
+        std::function<bool(const std::string &)> load_section = [this](const std::string &name) {
+            return _config_section_needed(name);
+        };
+        // with several files, each key is only looked up in the file of highest precedence holding it
+        config_keys_t applied;
+        config_keys_t *merge = (config_files.size() > 1) ? &applied : nullptr;
         for(auto rit = config_files.rbegin(); rit != config_files.rend(); ++rit) {
             const auto &config_file = *rit;
             auto path_result = detail::check_path(config_file.c_str());
             if(path_result == detail::path_type::file) {
                 try {
-                    std::vector<ConfigItem> values = config_formatter_->from_file(config_file);
-                    _parse_config(values);
+                    std::function<void(const ConfigItem &)> parse_item = [this](const ConfigItem &item) {
+                        if(!_parse_single_config(item) && allow_config_extras_ == config_extras_mode::error)
+                            throw ConfigError::Extras(item.fullname());
+                    };
+                    // the decoder of the options is only built for a format reading the file through it
+                    if(!config_formatter_->supports_decode() ||
+                       !config_formatter_->decode_file(config_file, _config_decoder(), parse_item, load_section)) {
+                        config_items_t values = _read_config_file(config_file, load_section);
+                        _parse_config(values, merge);
+                    }
+                    if(!file_given) {
+                        config_ptr_->add_result(config_file);
+                    }
+                } catch(const FileError &) {
+                    if(config_required || file_given)
+                        throw;
+                }
+            } else if(path_result == detail::path_type::directory || detail::has_wildcards(config_file)) {
+                // a conf.d directory, or a glob on the files of a directory
+                std::string directory = config_file;
+                std::string pattern = "*";
+                if(path_result != detail::path_type::directory) {
+                    auto split = config_file.find_last_of("/\\");
+                    directory = (split == std::string::npos) ? std::string(".") : config_file.substr(0, split);
+                    pattern = config_file.substr(split == std::string::npos ? 0 : split + 1);
+                }
+                if(detail::check_path(directory.c_str()) != detail::path_type::directory) {
+                    if(config_required || file_given) {
+                        throw FileError::Missing(config_file);
+                    }
+                    continue;
+                }
+                try {
+                    _process_config_directory(detail::list_directory(directory, pattern), load_section, &applied);
                     if(!file_given) {
                         config_ptr_->add_result(config_file);
                     }
@@ -999,6 +1175,161 @@ CLI11_INLINE void App::_process_config_file() {
     }
 }
 
+#ifdef CLI11_CPP17
+CLI11_INLINE void App::_process_static_config() {
+    if(static_config_ != nullptr) {
+        _parse_config(CompactConfig(*static_config_));
+    }
+}
+#endif
+
+CLI11_INLINE bool App::_config_section_needed(const std::string &name) const {
+    const App *subcom = _find_subcommand(name, false, false);
+    // options and unknown names are always needed, a subcommand once used or if the configuration can trigger it
+    return subcom == nullptr || subcom->get_configurable() || subcom->count_all() > 0;
+}
+
+CLI11_INLINE const ConfigDecoder &App::_config_decoder() {
+    if(!config_decoder_) {
+        config_decoder_.reset(new ConfigDecoder());
+        _add_config_setters(*config_decoder_, std::string{});
+    }
+    return *config_decoder_;
+}
+
+CLI11_INLINE void App::_add_config_setters(ConfigDecoder &decoder, const std::string &prefix) const {
+    // the options and subcommands found through the nameless subcommands, in the order of the lookups
+    std::vector<Option *> options;
+    std::vector<const App *> subcommands;
+    std::function<void(const App *)> collect = [&](const App *app) {
+        for(const Option_p &opt : app->options_) {
+            options.push_back(opt.get());
+        }
+        for(const App_p &sub : app->subcommands_) {
+            if(sub->get_name().empty()) {
+                collect(sub.get());
+            } else {
+                subcommands.push_back(sub.get());
+            }
+        }
+    };
+    collect(this);
+
+    // names matched without case or underscores are left to _parse_single_config
+    bool exact = std::none_of(options.begin(), options.end(), [](const Option *opt) {
+        return opt->get_ignore_case() || opt->get_ignore_underscore();
+    });
+    if(exact) {
+        auto add = [&decoder, &prefix](const std::string &name, Option *opt) {
+            std::string key = prefix;
+            ConfigDecoder::append(key, name);
+            decoder.add(std::move(key), [opt](const ConfigValue &value, const std::string &input) {
+                // flags and options which are not configurable go through _parse_single_config
+                if(!opt->get_configurable() || opt->get_expected_min() == 0) {
+                    return false;
+                }
+                if(opt->empty()) {
+                    opt->add_result(input);
+                    if(!opt->_assign_config_value(value)) {
+                        opt->run_callback();
+                    }
+                }
+                return true;
+            });
+        };
+        // same precedence as _parse_single_config: long names, then short names, then the other names
+        for(Option *opt : options) {
+            for(const std::string &lname : opt->get_lnames()) {
+                add(lname, opt);
+            }
+        }
+        for(Option *opt : options) {
+            for(const std::string &sname : opt->get_snames()) {
+                add(sname, opt);
+            }
+        }
+        for(Option *opt : options) {
+            for(const std::string *name : {&opt->pname_, &opt->envname_}) {
+                if(!name->empty() && name->front() != '-') {
+                    add(*name, opt);
+                }
+            }
+        }
+    }
+
+    for(const App *sub : subcommands) {
+        if(sub->get_ignore_case() || sub->get_ignore_underscore()) {
+            continue;
+        }
+        std::vector<std::string> names = sub->get_aliases();
+        names.insert(names.begin(), sub->get_name());
+        for(const std::string &name : names) {
+            std::string key = prefix;
+            ConfigDecoder::append(key, name);
+            sub->_add_config_setters(decoder, key);
+        }
+    }
+}
+
+CLI11_INLINE void App::_reset_config_decoder() {
+    for(App *app = this; app != nullptr; app = app->parent_) {
+        app->config_decoder_.reset();
+    }
+}
+
+CLI11_INLINE App::config_items_t
+App::_read_config_file(const std::string &name, const std::function<bool(const std::string &)> &load_section) const {
+#ifdef CLI11_CPP17
+    if(config_formatter_->supports_compact()) {
+        return config_formatter_->from_file_compact(name, load_section);
+    }
+    return CompactConfig(config_formatter_->from_file(name, load_section));
+#else
+    return config_formatter_->from_file(name, load_section);
+#endif
+}
+
+CLI11_INLINE void App::_process_config_directory(const std::vector<std::string> &config_files,
+                                                 const std::function<bool(const std::string &)> &load_section,
+                                                 config_keys_t *applied) {
+    std::vector<config_items_t> values(config_files.size());
+    std::vector<std::exception_ptr> errors(config_files.size());
+    std::atomic<std::size_t> next{0};
+    auto parse_files = [&]() {
+        for(std::size_t index = next++; index < config_files.size(); index = next++) {
+            try {
+                values[index] = _read_config_file(config_files[index], load_section);
+            } catch(...) {
+                errors[index] = std::current_exception();
+            }
+        }
+    };
+
+    // a small pool, the calling thread takes its share of the files
+    std::size_t thread_count = (std::min)(config_files.size(), static_cast<std::size_t>(8));
+    thread_count = (std::min)(thread_count, static_cast<std::size_t>((std::max)(std::thread::hardware_concurrency(), 1U)));
+    std::vector<std::thread> threads;
+    for(std::size_t ii = 1; ii < thread_count; ++ii) {
+        try {
+            threads.emplace_back(parse_files);
+        } catch(const std::system_error &) {
+            break;
+        }
+    }
+    parse_files();
+    for(auto &thread : threads) {
+        thread.join();
+    }
+
+    // same precedence as the files given one by one, the error of a file is only raised when it is reached
+    for(std::size_t index = config_files.size(); index-- > 0;) {
+        if(errors[index]) {
+            std::rethrow_exception(errors[index]);
+        }
+        _parse_config(values[index], applied);
+    }
+}
+
 CLI11_INLINE void App::_process_env() {
     for(const Option_p &opt : options_) {
         if(opt->count() == 0 && !opt->envname_.empty()) {
@@ -1210,6 +1541,9 @@ CLI11_INLINE void App::_process() {
         // the config file might generate a FileError but that should not be processed until later in the process
         // to allow for help, version and other errors to generate first.
         _process_config_file();
+#ifdef CLI11_CPP17
+        _process_static_config();
+#endif
 
         // process env shouldn't throw but no reason to process it if config generated an error
         _process_env();
@@ -1319,13 +1653,64 @@ CLI11_INLINE void App::_parse_stream(std::istream &input) {
     _process_extras();
 }
 
-CLI11_INLINE void App::_parse_config(const std::vector<ConfigItem> &args) {
+CLI11_INLINE void App::_parse_config(const std::vector<ConfigItem> &args, config_keys_t *applied) {
+    std::string key;
     for(const ConfigItem &item : args) {
+        if(applied != nullptr && item.name != "++" && item.name != "--") {
+            // the parents and the name, joined by a character they cannot hold
+            key.clear();
+            for(const auto &parent : item.parents) {
+                key.append(parent).push_back('\0');
+            }
+            key.append(item.name);
+            if(!applied->insert(key).second)
+                continue;
+        }
         if(!_parse_single_config(item) && allow_config_extras_ == config_extras_mode::error)
             throw ConfigError::Extras(item.fullname());
     }
 }
 
+#ifdef CLI11_CPP17
+CLI11_INLINE void App::_parse_config(const CompactConfig &args, config_keys_t *applied) {
+    // a child path is always interned after its parent, so one pass finds the app of every path
+    std::vector<App *> apps(args.path_count(), nullptr);
+    apps[CompactConfig::root] = this;
+    // and the key prefix of every path, for the merge of several files
+    std::vector<std::string> prefixes(applied != nullptr ? args.path_count() : 0);
+    for(CompactConfig::path_id path = 1; path < apps.size(); ++path) {
+        App *parent = apps[args.parent(path)];
+        if(parent != nullptr) {
+            apps[path] = parent->_find_subcommand(std::string(args.name(path)), false, false);
+        }
+        if(applied != nullptr) {
+            prefixes[path].append(prefixes[args.parent(path)]).append(args.name(path)).push_back('\0');
+        }
+    }
+
+    // a single item is filled for all of them, the parents only change with the path
+    ConfigItem item;
+    CompactConfig::path_id current = CompactConfig::root;
+    std::string key;
+    for(const auto &compact : args.items()) {
+        if(applied != nullptr && compact.name != "++" && compact.name != "--") {
+            key.assign(prefixes[compact.path]).append(compact.name);
+            if(!applied->insert(key).second)
+                continue;
+        }
+        if(compact.path != current) {
+            args.parents(compact.path, item.parents);
+            current = compact.path;
+        }
+        args.assign(compact, item);
+        App *app = apps[compact.path];
+        bool found = app != nullptr && app->_parse_single_config(item, item.parents.size());
+        if(!found && allow_config_extras_ == config_extras_mode::error)
+            throw ConfigError::Extras(item.fullname());
+    }
+}
+#endif
+
 CLI11_INLINE bool App::_parse_single_config(const ConfigItem &item, std::size_t level) {
     if(level < item.parents.size()) {
         try {
@@ -1392,7 +1777,9 @@ CLI11_INLINE bool App::_parse_single_config(const ConfigItem &item, std::size_t
 
         } else {
             op->add_result(item.inputs);
-            op->run_callback();
+            if(!op->_assign_config_value(item.value)) {
+                op->run_callback();
+            }
         }
     }
 
@@ -1494,7 +1881,7 @@ CLI11_INLINE bool App::_parse_positional(std::vector<std::string> &args, bool ha
                            opt->current_option_state_ == Option::option_state::callback_run) {
                             opt->clear();
                         }
-                        opt->add_result(positional);
+                        opt->add_result(std::move(args.back()));
                         if(opt->get_trigger_on_parse()) {
                             opt->run_callback();
                         }
@@ -1524,7 +1911,7 @@ CLI11_INLINE bool App::_parse_positional(std::vector<std::string> &args, bool ha
             if(opt->get_trigger_on_parse() && opt->current_option_state_ == Option::option_state::callback_run) {
                 opt->clear();
             }
-            opt->add_result(positional);
+            opt->add_result(std::move(args.back()));
             if(opt->get_trigger_on_parse()) {
                 opt->run_callback();
             }
@@ -1575,11 +1962,11 @@ CLI11_INLINE bool App::_parse_positional(std::vector<std::string> &args, bool ha
         return false;
     }
     /// We are out of other options this goes to missing
-    _move_to_missing(detail::Classifier::NONE, positional);
+    _move_to_missing(detail::Classifier::NONE, std::move(args.back()));
     args.pop_back();
     if(prefix_command_) {
         while(!args.empty()) {
-            _move_to_missing(detail::Classifier::NONE, args.back());
+            _move_to_missing(detail::Classifier::NONE, std::move(args.back()));
             args.pop_back();
         }
     }
@@ -1589,16 +1976,43 @@ CLI11_INLINE bool App::_parse_positional(std::vector<std::string> &args, bool ha
 
 CLI11_NODISCARD CLI11_INLINE App *
 App::_find_subcommand(const std::string &subc_name, bool ignore_disabled, bool ignore_used) const noexcept {
+    // the index gives the subcommand holding the name, even under nameless option groups
+    App *found = nullptr;
+    auto range = subcommand_index_.equal_range(subc_name);
+    for(auto it = range.first; it != range.second; ++it) {
+        if(found != nullptr && found != it->second.second) {
+            // several candidates, the first match in the order of the subcommands is needed
+            return _scan_subcommands(subc_name, ignore_disabled, ignore_used);
+        }
+        found = it->second.second;
+    }
+    if(found == nullptr || (found->disabled_ && ignore_disabled)) {
+        return nullptr;
+    }
+    // the apps between this one and the holder of the name must still be enabled nameless groups
+    for(const App *group = found->parent_; group != this; group = group->parent_) {
+        if(!group->get_name().empty() || (group->disabled_ && ignore_disabled)) {
+            return nullptr;
+        }
+    }
+    if(found->_check_name(subc_name) && ((!*found) || !ignore_used)) {
+        return found;
+    }
+    return nullptr;
+}
+
+CLI11_NODISCARD CLI11_INLINE App *
+App::_scan_subcommands(const std::string &subc_name, bool ignore_disabled, bool ignore_used) const noexcept {
     for(const App_p &com : subcommands_) {
         if(com->disabled_ && ignore_disabled)
             continue;
         if(com->get_name().empty()) {
-            auto *subc = com->_find_subcommand(subc_name, ignore_disabled, ignore_used);
+            auto *subc = com->_scan_subcommands(subc_name, ignore_disabled, ignore_used);
             if(subc != nullptr) {
                 return subc;
             }
         }
-        if(com->check_name(subc_name)) {
+        if(com->_check_name(subc_name)) {
             if((!*com) || !ignore_used)
                 return com.get();
         }
@@ -1636,7 +2050,8 @@ CLI11_INLINE bool App::_parse_subcommand(std::vector<std::string> &args) {
 
 CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classifier current_type) {
 
-    std::string current = args.back();
+    // the argument is only moved out of args once it is used here, a nameless group or a parent may take it
+    const std::string &current = args.back();
 
     std::string arg_name;
     std::string value;
@@ -1663,17 +2078,15 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
         throw HorribleError("parsing got called with invalid option! You should not see this");
     }
 
-    auto op_ptr = std::find_if(std::begin(options_), std::end(options_), [arg_name, current_type](const Option_p &opt) {
-        if(current_type == detail::Classifier::LONG)
-            return opt->check_lname(arg_name);
-        if(current_type == detail::Classifier::SHORT)
-            return opt->check_sname(arg_name);
-        // this will only get called for detail::Classifier::WINDOWS_STYLE
-        return opt->check_lname(arg_name) || opt->check_sname(arg_name);
-    });
+    // windows style options match both the long and the short names
+    std::size_t position = options_.size();
+    if(current_type != detail::Classifier::SHORT)
+        position = _find_option('l', arg_name, position);
+    if(current_type != detail::Classifier::LONG)
+        position = _find_option('s', arg_name, position);
 
     // Option not found
-    if(op_ptr == std::end(options_)) {
+    if(position == options_.size()) {
         for(auto &subc : subcommands_) {
             if(subc->name_.empty() && !subc->disabled_) {
                 if(subc->_parse_arg(args, current_type)) {
@@ -1695,15 +2108,15 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
             return _get_fallthrough_parent()->_parse_arg(args, current_type);
 
         // Otherwise, add to missing
+        _move_to_missing(current_type, std::move(args.back()));
         args.pop_back();
-        _move_to_missing(current_type, current);
         return true;
     }
 
     args.pop_back();
 
     // Get a reference to the pointer to make syntax bearable
-    Option_p &op = *op_ptr;
+    Option_p &op = options_[position];
     /// if we require a separator add it here
     if(op->get_inject_separator()) {
         if(!op->results().empty() && !op->results().back().empty()) {
@@ -1727,15 +2140,15 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
     // deal with purely flag like things
     if(max_num == 0) {
         auto res = op->get_flag_value(arg_name, value);
-        op->add_result(res);
+        op->add_result(std::move(res));
         parse_order_.push_back(op.get());
     } else if(!value.empty()) {  // --this=value
-        op->add_result(value, result_count);
+        op->add_result(std::move(value), result_count);
         parse_order_.push_back(op.get());
         collected += result_count;
         // -Trest
     } else if(!rest.empty()) {
-        op->add_result(rest, result_count);
+        op->add_result(std::move(rest), result_count);
         parse_order_.push_back(op.get());
         rest = "";
         collected += result_count;
@@ -1743,9 +2156,8 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
 
     // gather the minimum number of arguments
     while(min_num > collected && !args.empty()) {
-        std::string current_ = args.back();
+        op->add_result(std::move(args.back()), result_count);
         args.pop_back();
-        op->add_result(current_, result_count);
         parse_order_.push_back(op.get());
         collected += result_count;
     }
@@ -1771,7 +2183,7 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
                     break;
                 }
             }
-            op->add_result(args.back(), result_count);
+            op->add_result(std::move(args.back()), result_count);
             parse_order_.push_back(op.get());
             args.pop_back();
             collected += result_count;
@@ -1783,7 +2195,7 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
         // optional flag that didn't receive anything now get the default value
         if(min_num == 0 && max_num > 0 && collected == 0) {
             auto res = op->get_flag_value(arg_name, std::string{});
-            op->add_result(res);
+            op->add_result(std::move(res));
             parse_order_.push_back(op.get());
         }
     }
@@ -1799,8 +2211,7 @@ CLI11_INLINE bool App::_parse_arg(std::vector<std::string> &args, detail::Classi
         op->run_callback();
     }
     if(!rest.empty()) {
-        rest = "-" + rest;
-        args.push_back(rest);
+        args.push_back("-" + rest);
     }
     return true;
 }
@@ -1840,42 +2251,29 @@ CLI11_NODISCARD CLI11_INLINE const std::string &App::_compare_subcommand_names(c
     if(subcom.disabled_) {
         return estring;
     }
-    for(const auto &subc : base.subcommands_) {
-        if(subc.get() != &subcom) {
-            if(subc->disabled_) {
-                continue;
-            }
-            if(!subcom.get_name().empty()) {
-                if(subc->check_name(subcom.get_name())) {
-                    return subcom.get_name();
-                }
-            }
-            if(!subc->get_name().empty()) {
-                if(subcom.check_name(subc->get_name())) {
-                    return subc->get_name();
-                }
-            }
-            for(const auto &les : subcom.aliases_) {
-                if(subc->check_name(les)) {
-                    return les;
-                }
-            }
-            // this loop is needed in case of ignore_underscore or ignore_case on one but not the other
-            for(const auto &les : subc->aliases_) {
-                if(subcom.check_name(les)) {
-                    return les;
-                }
-            }
-            // if the subcommand is an option group we need to check deeper
-            if(subc->get_name().empty()) {
-                const auto &cmpres = _compare_subcommand_names(subcom, *subc);
-                if(!cmpres.empty()) {
-                    return cmpres;
-                }
+    // only the subcommands sharing a folded name can conflict
+    std::vector<subcommand_key_t> keys;
+    _subcommand_keys(subcom, nullptr, keys);
+    const auto &index = base.subcommand_index_;
+    std::vector<const App *> candidates;
+    for(const auto &key : keys) {
+        auto range = index.equal_range(key.first);
+        for(auto it = range.first; it != range.second; ++it) {
+            const App *subc = it->second.first;
+            if(subc != &subcom &&
+               std::find(std::begin(candidates), std::end(candidates), subc) == std::end(candidates)) {
+                candidates.push_back(subc);
             }
-            // if the test subcommand is an option group we need to check deeper
-            if(subcom.get_name().empty()) {
-                const auto &cmpres = _compare_subcommand_names(*subc, subcom);
+        }
+    }
+    if(candidates.size() == 1) {
+        return _compare_subcommand_name(subcom, *candidates.front());
+    }
+    if(!candidates.empty()) {
+        // the first conflict in the order of the subcommands is reported
+        for(const auto &subc : base.subcommands_) {
+            if(std::find(std::begin(candidates), std::end(candidates), subc.get()) != std::end(candidates)) {
+                const auto &cmpres = _compare_subcommand_name(subcom, *subc);
                 if(!cmpres.empty()) {
                     return cmpres;
                 }
@@ -1885,20 +2283,106 @@ CLI11_NODISCARD CLI11_INLINE const std::string &App::_compare_subcommand_names(c
     return estring;
 }
 
-CLI11_INLINE void App::_move_to_missing(detail::Classifier val_type, const std::string &val) {
+CLI11_NODISCARD CLI11_INLINE const std::string &App::_compare_subcommand_name(const App &subcom,
+                                                                              const App &subc) const {
+    static const std::string estring;
+    if(subc.disabled_) {
+        return estring;
+    }
+    if(!subcom.get_name().empty()) {
+        if(subc.check_name(subcom.get_name())) {
+            return subcom.get_name();
+        }
+    }
+    if(!subc.get_name().empty()) {
+        if(subcom.check_name(subc.get_name())) {
+            return subc.get_name();
+        }
+    }
+    for(const auto &les : subcom.aliases_) {
+        if(subc.check_name(les)) {
+            return les;
+        }
+    }
+    // this loop is needed in case of ignore_underscore or ignore_case on one but not the other
+    for(const auto &les : subc.aliases_) {
+        if(subcom.check_name(les)) {
+            return les;
+        }
+    }
+    // if the subcommand is an option group we need to check deeper
+    if(subc.get_name().empty()) {
+        const auto &cmpres = _compare_subcommand_names(subcom, subc);
+        if(!cmpres.empty()) {
+            return cmpres;
+        }
+    }
+    // if the test subcommand is an option group we need to check deeper
+    if(subcom.get_name().empty()) {
+        const auto &cmpres = _compare_subcommand_names(subc, subcom);
+        if(!cmpres.empty()) {
+            return cmpres;
+        }
+    }
+    return estring;
+}
+
+CLI11_INLINE void App::_subcommand_keys(const App &app, App *holder, std::vector<subcommand_key_t> &keys) {
+    // the same folding as the option names, a superset of the matches of check_name
+    if(!app.name_.empty()) {
+        keys.emplace_back(detail::to_lower(detail::remove_underscore(app.name_)), holder);
+    }
+    for(const auto &alias : app.aliases_) {
+        keys.emplace_back(detail::to_lower(detail::remove_underscore(alias)), holder);
+    }
+    if(app.name_.empty()) {
+        for(const auto &subc : app.subcommands_) {
+            _subcommand_keys(*subc, subc.get(), keys);
+        }
+    }
+}
+
+CLI11_INLINE void App::_index_subcommand_keys(App *subcom, const std::vector<subcommand_key_t> &keys) {
+    // the names under a nameless app are also found from its parent
+    App *child = subcom;
+    for(App *app = this; app != nullptr; child = app, app = app->parent_) {
+        for(const auto &key : keys) {
+            app->subcommand_index_.emplace(key.first, std::make_pair(child, key.second));
+        }
+        if(!app->name_.empty()) {
+            break;
+        }
+    }
+}
+
+CLI11_INLINE void App::_rebuild_subcommand_index() {
+    std::vector<subcommand_key_t> keys;
+    for(App *app = this; app != nullptr; app = app->parent_) {
+        app->subcommand_index_.clear();
+        for(const App_p &subc : app->subcommands_) {
+            keys.clear();
+            _subcommand_keys(*subc, subc.get(), keys);
+            for(auto &key : keys) {
+                app->subcommand_index_.emplace(std::move(key.first), std::make_pair(subc.get(), key.second));
+            }
+        }
+    }
+}
+
+CLI11_INLINE void App::_move_to_missing(detail::Classifier val_type, std::string val) {
     if(allow_extras_ || subcommands_.empty()) {
-        missing_.emplace_back(val_type, val);
+        missing_.emplace_back(val_type, std::move(val));
         return;
     }
     // allow extra arguments to be places in an option group if it is allowed there
     for(auto &subc : subcommands_) {
         if(subc->name_.empty() && subc->allow_extras_) {
-            subc->missing_.emplace_back(val_type, val);
+            subc->missing_.emplace_back(val_type, std::move(val));
             return;
         }
     }
     // if we haven't found any place to put them yet put them in missing
-    missing_.emplace_back(val_type, val);
+    missing_.emplace_back(val_type, std::move(val));
 }
 
 CLI11_INLINE void App::_move_option(Option *opt, App *app) {
@@ -1926,12 +2410,14 @@ CLI11_INLINE void App::_move_option(Option *opt, App *app) {
         std::find_if(std::begin(options_), std::end(options_), [opt](const Option_p &v) { return v.get() == opt; });
     if(iterator != std::end(options_)) {
         const auto &opt_p = *iterator;
-        if(std::find_if(std::begin(app->options_), std::end(app->options_), [&opt_p](const Option_p &v) {
-               return (*v == *opt_p);
-           }) == std::end(app->options_)) {
+        if(app->_find_matching_option(*opt_p) == app->options_.size()) {
             // only erase after the insertion was successful
             app->options_.push_back(std::move(*iterator));
             options_.erase(iterator);
+            _rebuild_option_index();
+            app->_index_option(app->options_.size() - 1);
+            _reset_config_decoder();
+            app->_reset_config_decoder();
         } else {
             throw OptionAlreadyAdded("option was not located: " + opt->get_name());
         }
@@ -11,7 +11,10 @@
 
 // [CLI11:public_includes:set]
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <string>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 // [CLI11:public_includes:end]
@@ -163,13 +166,308 @@ checkParentSegments(std::vector<ConfigItem> &output, const std::string &currentS
     output.back().parents = std::move(parents);
     output.back().name = "++";
 }
+
+CLI11_INLINE MappedFile::~MappedFile() {
+#if CLI11_HAS_MMAP > 0
+    if(data_ != nullptr) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+}
+
+CLI11_INLINE bool MappedFile::open(const std::string &name) {
+#if CLI11_HAS_MMAP > 0
+    int fd = ::open(name.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat buffer {};
+    if(fstat(fd, &buffer) != 0 || !S_ISREG(buffer.st_mode) || buffer.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    auto size = static_cast<std::size_t>(buffer.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the descriptor is closed
+    ::close(fd);
+    if(data == MAP_FAILED) {
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(data, size, MADV_SEQUENTIAL);
+#endif
+    data_ = static_cast<const char *>(data);
+    size_ = size;
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+CLI11_INLINE BufferStreambuf::BufferStreambuf(const char *data, std::size_t size) {
+    // the get area is never written to, the const_cast is only needed by the streambuf interface
+    char *begin = const_cast<char *>(data);
+    setg(begin, begin, begin + size);
+}
+
+CLI11_INLINE BufferStreambuf::pos_type
+BufferStreambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+    if((which & std::ios_base::in) == 0) {
+        return pos_type(off_type(-1));
+    }
+    char *target = (dir == std::ios_base::beg) ? eback() : (dir == std::ios_base::cur) ? gptr() : egptr();
+    target += off;
+    if(target < eback() || target > egptr()) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), target, egptr());
+    return pos_type(target - eback());
+}
+
+CLI11_INLINE BufferStreambuf::pos_type BufferStreambuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
 }  // namespace detail
 
+#ifdef CLI11_CPP17
+CLI11_INLINE CompactConfig::CompactConfig() { paths_.push_back(Path{root, std::string_view{}, 0}); }
+
+CLI11_INLINE CompactConfig::CompactConfig(const std::vector<ConfigItem> &items) : CompactConfig() {
+    items_.reserve(items.size());
+    for(const auto &item : items) {
+        add(item);
+    }
+}
+
+CLI11_INLINE CompactConfig::CompactConfig(const StaticConfig &config) : CompactConfig() {
+    // the ids of the sections, a section written twice in the table gets the id of the first one
+    std::vector<path_id> ids(config.section_count + 1, root);
+    paths_.reserve(config.section_count + 1);
+    for(std::size_t index = 0; index < config.section_count; ++index) {
+        const StaticConfig::Section &section = config.sections[index];
+        Key key{ids[section.parent], section.name};
+        auto found = index_.find(key);
+        if(found != index_.end()) {
+            ids[index + 1] = found->second;
+            continue;
+        }
+        ids[index + 1] = static_cast<path_id>(paths_.size());
+        paths_.push_back(Path{key.parent, section.name, paths_[key.parent].depth + 1});
+        index_.emplace(key, ids[index + 1]);
+    }
+    items_.reserve(config.item_count);
+    for(std::size_t index = 0; index < config.item_count; ++index) {
+        const StaticConfig::Item &item = config.items[index];
+        items_.push_back(Item{ids[item.section], item.name, item.first_input, item.input_count, item.value});
+    }
+    inputs_.assign(config.inputs, config.inputs + config.input_count);
+}
+
+CLI11_INLINE CompactConfig::path_id CompactConfig::path(path_id parent, std::string_view name) {
+    auto found = index_.find(Key{parent, name});
+    if(found != index_.end()) {
+        return found->second;
+    }
+    auto id = static_cast<path_id>(paths_.size());
+    Path entry{parent, store(name), paths_[parent].depth + 1};
+    paths_.push_back(entry);
+    index_.emplace(Key{parent, entry.name}, id);
+    return id;
+}
+
+CLI11_INLINE CompactConfig::path_id CompactConfig::path(const std::vector<std::string> &parents) {
+    path_id id = root;
+    for(const auto &parent : parents) {
+        id = path(id, parent);
+    }
+    return id;
+}
+
+CLI11_INLINE std::string_view CompactConfig::store(std::string_view text) {
+    static constexpr std::size_t chunk_size = 16384;
+    if(text.empty()) {
+        return {};
+    }
+    if(text.size() > remaining_) {
+        // a large string gets its own chunk, the current one keeps its free space
+        if(text.size() > chunk_size / 4) {
+            chunks_.emplace_back(new char[text.size()]);
+            std::copy(text.begin(), text.end(), chunks_.back().get());
+            return {chunks_.back().get(), text.size()};
+        }
+        chunks_.emplace_back(new char[chunk_size]);
+        cursor_ = chunks_.back().get();
+        remaining_ = chunk_size;
+    }
+    char *start = cursor_;
+    std::copy(text.begin(), text.end(), start);
+    cursor_ += text.size();
+    remaining_ -= text.size();
+    return {start, text.size()};
+}
+
+CLI11_INLINE void CompactConfig::add(path_id parent, std::string_view name) {
+    Item item;
+    item.path = parent;
+    item.name = store(name);
+    item.first_input = static_cast<std::uint32_t>(inputs_.size());
+    items_.push_back(item);
+}
+
+CLI11_INLINE void CompactConfig::add(const ConfigItem &item) {
+    add(path(item.parents), item.name);
+    for(const auto &input : item.inputs) {
+        add_input(input);
+    }
+    set_value(item.value);
+}
+
+CLI11_INLINE void CompactConfig::add_input(std::string_view input) {
+    inputs_.push_back(store(input));
+    ++items_.back().input_count;
+}
+
+CLI11_INLINE void CompactConfig::repeat(path_id parent, const Item &item) {
+    Item copy = item;
+    copy.path = parent;
+    copy.first_input = static_cast<std::uint32_t>(inputs_.size());
+    items_.push_back(copy);
+    for(std::uint32_t index = item.first_input; index < item.first_input + item.input_count; ++index) {
+        std::string_view input = inputs_[index];
+        inputs_.push_back(input);
+    }
+}
+
+CLI11_INLINE void CompactConfig::append(CompactConfig &&other) {
+    for(auto &chunk : other.chunks_) {
+        chunks_.push_back(std::move(chunk));
+    }
+    std::vector<path_id> ids(other.paths_.size(), root);
+    for(path_id id = 1; id < other.paths_.size(); ++id) {
+        ids[id] = path(ids[other.paths_[id].parent], other.paths_[id].name);
+    }
+    auto offset = static_cast<std::uint32_t>(inputs_.size());
+    items_.reserve(items_.size() + other.items_.size());
+    for(Item item : other.items_) {
+        item.path = ids[item.path];
+        item.first_input += offset;
+        items_.push_back(item);
+    }
+    inputs_.insert(inputs_.end(), other.inputs_.begin(), other.inputs_.end());
+    other = CompactConfig();
+}
+
+CLI11_INLINE void CompactConfig::pop_back() {
+    inputs_.resize(items_.back().first_input);
+    items_.pop_back();
+}
+
+CLI11_INLINE void CompactConfig::parents(path_id path, std::vector<std::string> &output) const {
+    output.resize(paths_[path].depth);
+    for(std::size_t level = output.size(); level-- > 0; path = paths_[path].parent) {
+        output[level].assign(paths_[path].name.data(), paths_[path].name.size());
+    }
+}
+
+CLI11_INLINE void CompactConfig::assign(const Item &item, ConfigItem &output) const {
+    output.name.assign(item.name.data(), item.name.size());
+    output.inputs.resize(item.input_count);
+    const std::string_view *input = inputs(item);
+    for(auto &value : output.inputs) {
+        value.assign(input->data(), input->size());
+        ++input;
+    }
+    output.value = item.value;
+}
+
+CLI11_INLINE std::vector<ConfigItem> CompactConfig::to_items() const {
+    std::vector<ConfigItem> output(items_.size());
+    for(std::size_t index = 0; index < items_.size(); ++index) {
+        parents(items_[index].path, output[index].parents);
+        assign(items_[index], output[index]);
+    }
+    return output;
+}
+#endif
+
+CLI11_INLINE std::vector<ConfigItem> Config::from_buffer(const char *data, std::size_t size) const {
+    detail::BufferStreambuf buffer{data, size};
+    std::istream input{&buffer};
+    return from_config(input);
+}
+
+CLI11_INLINE std::vector<ConfigItem> Config::from_file(const std::string &name) const {
+    detail::MappedFile file;
+    if(file.open(name)) {
+        return from_buffer(file.data(), file.size());
+    }
+
+    std::ifstream input{name};
+    if(!input.good())
+        throw FileError::Missing(name);
+
+    return from_config(input);
+}
+
 inline std::vector<ConfigItem> ConfigBase::from_config(std::istream &input) const {
+    std::vector<ConfigItem> output;
+    parse_lines(input, output, {});
+    return output;
+}
+
+#ifdef CLI11_CPP17
+inline CompactConfig ConfigBase::from_config_compact(std::istream &input) const {
+    CompactConfig compact;
+    std::vector<ConfigItem> pending;
+    parse_lines(input, pending, [&compact](std::vector<ConfigItem> &parsed) {
+        if(parsed.size() > 1) {
+            for(auto it = parsed.begin(); it != std::prev(parsed.end()); ++it) {
+                compact.add(*it);
+            }
+            parsed.erase(parsed.begin(), std::prev(parsed.end()));
+        }
+    });
+    for(const auto &item : pending) {
+        compact.add(item);
+    }
+    return compact;
+}
+
+inline CompactConfig
+ConfigBase::from_file_compact(const std::string &name,
+                              const std::function<bool(const std::string &)> &load_section) const {
+    (void)load_section;
+    detail::MappedFile file;
+    if(file.open(name)) {
+        detail::BufferStreambuf buffer{file.data(), file.size()};
+        std::istream input{&buffer};
+        return from_config_compact(input);
+    }
+
+    std::ifstream input{name};
+    if(!input.good())
+        throw FileError::Missing(name);
+
+    return from_config_compact(input);
+}
+
+inline bool ConfigBase::supports_compact() const {
+#if CLI11_USE_STATIC_RTTI == 0
+    return typeid(*this) == typeid(ConfigBase) || typeid(*this) == typeid(ConfigINI);
+#else
+    // the dynamic type is unknown, the overrides of from_config are kept
+    return false;
+#endif
+}
+#endif
+
+inline void ConfigBase::parse_lines(std::istream &input,
+                                    std::vector<ConfigItem> &output,
+                                    const std::function<void(std::vector<ConfigItem> &)> &flush) const {
     std::string line;
     std::string currentSection = "default";
     std::string previousSection = "default";
-    std::vector<ConfigItem> output;
     bool isDefaultArray = (arrayStart == '[' && arrayEnd == ']' && arraySeparator == ',');
     bool isINIArray = (arrayStart == '\0' || arrayStart == ' ') && arrayStart == arrayEnd;
     bool inSection{false};
@@ -178,6 +476,9 @@ inline std::vector<ConfigItem> ConfigBase::from_config(std::istream &input) cons
     char aSep = (isINIArray && arraySeparator == ' ') ? ',' : arraySeparator;
     int currentSectionIndex{0};
     while(getline(input, line)) {
+        if(flush) {
+            flush(output);
+        }
         std::vector<std::string> items_buffer;
         std::string name;
 
@@ -294,7 +595,6 @@ inline std::vector<ConfigItem> ConfigBase::from_config(std::istream &input) cons
             output.back().parents.pop_back();
         }
     }
-    return output;
 }
 
 CLI11_INLINE std::string
@@ -178,15 +178,11 @@ template <typename T> Option *Option::ignore_case(bool value) {
     if(!ignore_case_ && value) {
         ignore_case_ = value;
         auto *parent = static_cast<T *>(parent_);
-        for(const Option_p &opt : parent->options_) {
-            if(opt.get() == this) {
-                continue;
-            }
-            const auto &omatch = opt->matching_name(*this);
-            if(!omatch.empty()) {
-                ignore_case_ = false;
-                throw OptionAlreadyAdded("adding ignore case caused a name conflict with " + omatch);
-            }
+        std::size_t match = parent->_find_matching_option(*this);
+        if(match < parent->options_.size()) {
+            std::string omatch = parent->options_[match]->matching_name(*this);
+            ignore_case_ = false;
+            throw OptionAlreadyAdded("adding ignore case caused a name conflict with " + omatch);
         }
     } else {
         ignore_case_ = value;
@@ -199,15 +195,11 @@ template <typename T> Option *Option::ignore_underscore(bool value) {
     if(!ignore_underscore_ && value) {
         ignore_underscore_ = value;
         auto *parent = static_cast<T *>(parent_);
-        for(const Option_p &opt : parent->options_) {
-            if(opt.get() == this) {
-                continue;
-            }
-            const auto &omatch = opt->matching_name(*this);
-            if(!omatch.empty()) {
-                ignore_underscore_ = false;
-                throw OptionAlreadyAdded("adding ignore underscore caused a name conflict with " + omatch);
-            }
+        std::size_t match = parent->_find_matching_option(*this);
+        if(match < parent->options_.size()) {
+            std::string omatch = parent->options_[match]->matching_name(*this);
+            ignore_underscore_ = false;
+            throw OptionAlreadyAdded("adding ignore underscore caused a name conflict with " + omatch);
         }
     } else {
         ignore_underscore_ = value;
@@ -307,6 +299,20 @@ CLI11_INLINE void Option::run_callback() {
     }
 }
 
+CLI11_INLINE bool Option::_assign_config_value(const ConfigValue &value) {
+    if(!config_value_setter_ || value.type == ConfigValue::value_type::none || force_callback_ ||
+       !validators_.empty() || results_.size() != 1 || get_items_expected_max() != 1 ||
+       current_option_state_ != option_state::parsing) {
+        return false;
+    }
+    if(!config_value_setter_(value, results_.front())) {
+        return false;
+    }
+    // nothing to validate or reduce, the results stay available for count and as
+    current_option_state_ = option_state::callback_run;
+    return true;
+}
+
 CLI11_NODISCARD CLI11_INLINE const std::string &Option::matching_name(const Option &other) const {
     static const std::string estring;
     for(const std::string &sname : snames_)
@@ -10,6 +10,7 @@
 #include <CLI/StringTools.hpp>
 
 // [CLI11:public_includes:set]
+#include <locale>
 #include <string>
 #include <vector>
 // [CLI11:public_includes:end]
@@ -152,25 +153,69 @@ CLI11_INLINE void remove_default_flag_values(std::string &flags) {
     flags.erase(std::remove(flags.begin(), flags.end(), '!'), flags.end());
 }
 
+CLI11_INLINE bool equal_folded(const std::string &name,
+                               bool name_underscore,
+                               const std::string &other,
+                               bool other_underscore,
+                               bool ignore_case) noexcept {
+    // the same folding as to_lower and remove_underscore
+    std::locale locale;
+    const auto &ctype = std::use_facet<std::ctype<char>>(locale);
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while(true) {
+        while(name_underscore && i < name.size() && name[i] == '_') {
+            ++i;
+        }
+        while(other_underscore && j < other.size() && other[j] == '_') {
+            ++j;
+        }
+        if(i == name.size() || j == other.size()) {
+            return i == name.size() && j == other.size();
+        }
+        char c1 = name[i++];
+        char c2 = other[j++];
+        if(ignore_case) {
+            c1 = ctype.tolower(c1);
+            c2 = ctype.tolower(c2);
+        }
+        if(c1 != c2) {
+            return false;
+        }
+    }
+}
+
+CLI11_INLINE std::size_t folded_hash::operator()(const std::string &name) const noexcept {
+    std::locale locale;
+    const auto &ctype = std::use_facet<std::ctype<char>>(locale);
+    std::size_t value = 0;
+    for(char c : name) {
+        if(c != '_') {
+            value = value * 31U + static_cast<unsigned char>(ctype.tolower(c));
+        }
+    }
+    return value;
+}
+
 CLI11_INLINE std::ptrdiff_t
-find_member(std::string name, const std::vector<std::string> names, bool ignore_case, bool ignore_underscore) {
+find_member(std::string name, const std::vector<std::string> &names, bool ignore_case, bool ignore_underscore) {
     auto it = std::end(names);
     if(ignore_case) {
         if(ignore_underscore) {
             name = detail::to_lower(detail::remove_underscore(name));
-            it = std::find_if(std::begin(names), std::end(names), [&name](std::string local_name) {
+            it = std::find_if(std::begin(names), std::end(names), [&name](const std::string &local_name) {
                 return detail::to_lower(detail::remove_underscore(local_name)) == name;
             });
         } else {
             name = detail::to_lower(name);
-            it = std::find_if(std::begin(names), std::end(names), [&name](std::string local_name) {
+            it = std::find_if(std::begin(names), std::end(names), [&name](const std::string &local_name) {
                 return detail::to_lower(local_name) == name;
             });
         }
 
     } else if(ignore_underscore) {
         name = detail::remove_underscore(name);
-        it = std::find_if(std::begin(names), std::end(names), [&name](std::string local_name) {
+        it = std::find_if(std::begin(names), std::end(names), [&name](const std::string &local_name) {
             return detail::remove_underscore(local_name) == name;
         });
     } else {
@@ -13,9 +13,11 @@
 #include <CLI/TypeTools.hpp>
 
 // [CLI11:public_includes:set]
+#include <algorithm>
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 // [CLI11:public_includes:end]
 
 namespace CLI {
@@ -165,6 +167,70 @@ CLI11_INLINE path_type check_path(const char *file) noexcept {
 }
 #endif
 
+CLI11_INLINE bool has_wildcards(const std::string &path) {
+    auto start = path.find_last_of("/\\");
+    start = (start == std::string::npos) ? 0 : start + 1;
+    return path.find_first_of("*?", start) != std::string::npos;
+}
+
+CLI11_INLINE bool wildcard_match(const std::string &name, const std::string &pattern) {
+    std::size_t n = 0, p = 0;
+    std::size_t star = std::string::npos, mark = 0;
+    while(n < name.size()) {
+        if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++n;
+            ++p;
+        } else if(p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            mark = n;
+        } else if(star != std::string::npos) {
+            // backtrack, the last * takes one more character
+            p = star + 1;
+            n = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while(p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+CLI11_INLINE std::vector<std::string> list_directory(const std::string &directory, const std::string &pattern) {
+    std::vector<std::string> names;
+    bool hidden = !pattern.empty() && pattern.front() == '.';
+    auto keep = [&](const std::string &name) {
+        return (hidden || name.empty() || name.front() != '.') && wildcard_match(name, pattern);
+    };
+#if defined CLI11_HAS_FILESYSTEM && CLI11_HAS_FILESYSTEM > 0
+    std::error_code ec;
+    for(const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if(entry.is_regular_file(ec) && keep(name)) {
+            names.push_back(std::move(name));
+        }
+    }
+#elif !defined(_WIN32)
+    DIR *dir = opendir(directory.c_str());
+    if(dir != nullptr) {
+        while(const dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            struct stat buffer;
+            if(keep(name) && stat((directory + '/' + name).c_str(), &buffer) == 0 && S_ISREG(buffer.st_mode)) {
+                names.push_back(std::move(name));
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(names.begin(), names.end());
+    for(auto &name : names) {
+        name = directory + '/' + name;
+    }
+    return names;
+}
+
 CLI11_INLINE ExistingFileValidator::ExistingFileValidator() : Validator("FILE") {
     func_ = [](std::string &filename) {
         auto path_result = check_path(filename.c_str());
@@ -7,15 +7,267 @@ namespace CLI {
 
 // --------------------------------------------------------------------------
 class ConfigYAML : public Config {
+protected:
+    /// Build the items straight from the parser events instead of loading a YAML::Node tree
+    bool streamingMode{false};
+    /// Directory of the binary cache of the parsed files, no cache when empty
+    std::string cacheDirectory{};
+    /// Only convert the top level sections needed by the app
+    bool lazyMode{false};
+    /// Set the options of the app straight from the document, through the decoder table of the app
+    bool decodeMode{false};
+    /// Scan the documents written in the common subset of YAML without yaml-cpp
+    bool scannerMode{true};
+    /// Number of threads converting the top level keys of a document, converted in one piece below 2
+    unsigned parallelThreads{0};
+    /// Smallest part of a document given to a thread, in bytes
+    std::size_t parallelMinimum{65536};
+    /// The limits of a document, 0 for no limit
+    std::size_t maximumDepth{0};
+    std::size_t maximumItems{0};
+    std::size_t maximumSequence{0};
+    std::size_t maximumScalar{0};
+    /// Specify the configuration index to use when the section is a sequence of maps
+    int16_t configIndex{-1};
+    /// Specify the configuration section that should be used, a path of keys separated by '.'
+    std::string configSection{};
+
 public:
     /// Convert an app into a configuration
     std::string to_config(const App *, bool, bool, std::string) const override;
 
+    /// Parse a config file, or load its items from the cache when it is enabled and the file did not change
+    std::vector<ConfigItem> from_file(const std::string& name) const override;
+
+    /// Parse a config file, in lazy mode the top level sections rejected by load_section are not converted
+    std::vector<ConfigItem> from_file(const std::string& name,
+            const std::function<bool(const std::string&)>& load_section) const override;
+
     /// Convert a configuration into an app
     std::vector<ConfigItem> from_config(std::istream& is) const override;
 
+    /// Convert a configuration held in a contiguous buffer, the memory mapped file given by from_file
+    std::vector<ConfigItem> from_buffer(const char* data, std::size_t size) const override;
+
+    /// Convert a configuration into compact items, the parent paths are interned while the tree is walked
+    CompactConfig from_config_compact(std::istream& is) const override;
+
+    /// Parse a config file into compact items, with the cache or in streaming mode the items are converted
+    CompactConfig from_file_compact(const std::string& name,
+            const std::function<bool(const std::string&)>& load_section) const override;
+
+    /// True for a ConfigYAML, not for a class derived from it
+    bool supports_compact() const override;
+
+    /// Parse a config file straight into the options of an app when the decode mode is set
+    bool decode_file(const std::string& name, const ConfigDecoder& decoder,
+            const std::function<void(const ConfigItem&)>& item,
+            const std::function<bool(const std::string&)>& load_section) const override;
+
+    /// True in decode mode, unless the cache or the streaming mode is used
+    bool supports_decode() const override;
+
+    /// Specify if the items are built from the parser events, in one pass and without a YAML::Node tree
+    ConfigYAML* streaming(bool value = true) {
+        streamingMode = value;
+        return this;
+    }
+
+    /// Specify if the scalars of a config file are assigned to the options of the app while the document is
+    /// walked, without building the items, the flags and the sequences are still parsed as items
+    /// Not used with the cache or the streaming mode
+    ConfigYAML* decode(bool value = true) {
+        decodeMode = value;
+        return this;
+    }
+
+    /// Specify if the documents using only block maps, block sequences of scalars, single line scalars and comments
+    /// are read by the in-tree scanner, the other ones are loaded by yaml-cpp, the items are the same either way
+    /// Not used with a section or in streaming mode
+    ConfigYAML* scanner(bool value = true) {
+        scannerMode = value;
+        return this;
+    }
+
+    /// Specify the number of threads converting a document split at its top level keys, in parts of at least
+    /// `minimum` bytes; a document is converted in one piece when its keys cannot be shown to be independent
+    /// (several documents, an alias of an anchor in another part, a key line inside a multi-line scalar)
+    /// Not used with a section or in streaming mode
+    ConfigYAML* parallel(unsigned threads, std::size_t minimum = 65536) {
+        parallelThreads = threads;
+        parallelMinimum = minimum;
+        return this;
+    }
+
+    /// Specify if only the top level sections needed by the app are converted, the maps of the subcommands
+    /// that were not used on the command line and cannot be triggered by the configuration are skipped
+    ConfigYAML* lazy(bool value = true) {
+        lazyMode = value;
+        return this;
+    }
+
+    /// Specify the maximum depth of the nested maps and sequences, the root map being at depth 1 (0 for no limit)
+    /// A document exceeding one of the limits is rejected with a ConfigError as soon as it is read that far,
+    /// its items are built in the same pass, without the tree of yaml-cpp
+    ConfigYAML* maxDepth(std::size_t depth) {
+        maximumDepth = depth;
+        return this;
+    }
+
+    /// Specify the maximum number of values of a document: the scalars, the maps and the sequences, but not the
+    /// keys; the values of an anchored node are counted again at each of its aliases (0 for no limit)
+    /// With a limit, a document is not converted in parallel
+    ConfigYAML* maxItems(std::size_t items) {
+        maximumItems = items;
+        return this;
+    }
+
+    /// Specify the maximum number of elements of a sequence (0 for no limit)
+    ConfigYAML* maxSequenceLength(std::size_t length) {
+        maximumSequence = length;
+        return this;
+    }
+
+    /// Specify the maximum size in bytes of a scalar, a key or a value (0 for no limit)
+    ConfigYAML* maxScalarSize(std::size_t size) {
+        maximumScalar = size;
+        return this;
+    }
+
+    /// Keep the items parsed from the files in a binary cache in this directory, an empty directory disables it
+    /// A cache entry is only used while the path, size, modification time and content hash of the file match
+    /// Not used with a limit on the documents, they are always parsed to check it
+    ConfigYAML* cache(std::string directory) {
+        cacheDirectory = std::move(directory);
+        return this;
+    }
+
+    /// get a reference to the configuration section
+    std::string& sectionRef() { return configSection; }
+    /// get the section
+    const std::string& section() const { return configSection; }
+    /// specify the map of the file to use ("svc.api"), the other subtrees are skipped without being converted
+    ConfigYAML* section(const std::string& sectionName) {
+        configSection = sectionName;
+        return this;
+    }
+
+    /// get a reference to the configuration index
+    int16_t& indexRef() { return configIndex; }
+    /// get the section index
+    int16_t index() const { return configIndex; }
+    /// specify the map to use when the section is a sequence of maps, (-1) for all of them
+    ConfigYAML* index(int16_t sectionIndex) {
+        configIndex = sectionIndex;
+        return this;
+    }
+
+private:
+    struct Layers;
+
+    /// Convert a stream, load_section filters the top level sections when not null
+    /// text is the whole content of the stream when it reads a buffer, null for a stream read as needed
+    std::vector<ConfigItem> load(std::istream& is, const std::string_view* text,
+            const std::function<bool(const std::string&)>* load_section) const;
+
+    /// Convert a stream into compact items, load_section filters the top level sections when not null
+    CompactConfig load_compact(std::istream& is, const std::string_view* text,
+            const std::function<bool(const std::string&)>* load_section) const;
+
+    /// Build the items of a stream from the parser events, the limits are checked on the events in the same pass
+    std::vector<ConfigItem> stream(std::istream& is, const std::function<bool(const std::string&)>* load_section) const;
+
+    /// Load the documents of a stream, with the scanner or as YAML::Node trees, and give their items to output
+    /// A document outside the subset of the scanner is read by the streaming handler when a limit is set
+    /// The scanner and the split work on text when given, a stream is only read into a string for them
+    template <typename Output>
+    void convert(std::istream& is, const std::string_view* text, Output& output,
+            const std::function<bool(const std::string&)>* load_section) const;
+
+    /// Give the items of a single document to output with the scanner, false when it is not in the scanned subset
+    template <typename Output>
+    bool scan(std::string_view text, Output& output, const std::function<bool(const std::string&)>* load_section) const;
+
+    /// Convert the parts of a document split at its top level keys on several threads, false when it cannot be split
+    template <typename Output>
+    bool convert_parallel(std::string_view text, Output& output,
+            const std::function<bool(const std::string&)>* load_section) const;
+
+    /// Give the items of a node to output, parents is the path of the node and is restored on return
+    /// The nodes are walked from an explicit stack, the depth of a document does not grow the native one
+    /// With layers, the values already defined by a later document are skipped without being converted
+    /// With load_section, the top level sections it rejects are skipped without being converted
+    template <typename Output>
+    void parse(const YAML::Node& node, std::vector<std::string>& parents, Output& output,
+            Layers* layers = nullptr, const std::function<bool(const std::string&)>* load_section = nullptr) const;
+
+    /// Find the maps of the selected section in a document, the document itself without section
+    std::vector<YAML::Node> select(const YAML::Node& document, const std::vector<std::string>& section) const;
+
+    /// Merge the items of the documents of a stream, starting at the given offsets, the later documents first
+    std::vector<ConfigItem> overlay(std::vector<ConfigItem> items, const std::vector<std::size_t>& documents) const;
+};
+
+// --------------------------------------------------------------------------
+/// JSON config files, read by an in-tree parser straight from the buffer of the file
+/// Objects are sections and arrays are the inputs of an option, the items are the ones ConfigYAML gives for the
+/// same document
+class ConfigJSON : public Config {
+public:
+    /// Convert an app into a configuration, the descriptions are not written since JSON has no comments
+    std::string to_config(const App *, bool, bool, std::string) const override;
+
+    /// Convert a configuration into an app, the stream is read into a buffer first
+    std::vector<ConfigItem> from_config(std::istream& is) const override;
+
+    /// Convert a configuration held in a contiguous buffer, the memory mapped file given by from_file
+    std::vector<ConfigItem> from_buffer(const char* data, std::size_t size) const override;
+
+    /// Convert a configuration into compact items
+    CompactConfig from_config_compact(std::istream& is) const override;
+
+    /// Parse a config file into compact items, from the memory mapped file when possible
+    CompactConfig from_file_compact(const std::string& name,
+            const std::function<bool(const std::string&)>& load_section) const override;
+
+    /// True for a ConfigJSON, not for a class derived from it
+    bool supports_compact() const override;
+};
+
+// --------------------------------------------------------------------------
+/// Binary config files (.cfgb), the compiled items of a configuration written in another format, YAML usually
+/// A file holds a string table, a table of the sections and the items referring to them by offset, so it is loaded
+/// with a single read or memory map and the conversion of the offsets, without parsing any text
+class ConfigBinary : public Config {
+public:
+    /// Encode the items of a configuration, they are read back in the same order with the same typed values
+    static std::string encode(const std::vector<ConfigItem>& items);
+
+    /// Encode compact items
+    static std::string encode(const CompactConfig& items);
+
+    /// Convert an app into a binary configuration, holding the items of its YAML configuration
+    std::string to_config(const App *, bool, bool, std::string) const override;
+
+    /// Convert a configuration into an app, the stream is read into a buffer first
+    std::vector<ConfigItem> from_config(std::istream& is) const override;
+
+    /// Convert a configuration held in a contiguous buffer, the memory mapped file given by from_file
+    std::vector<ConfigItem> from_buffer(const char* data, std::size_t size) const override;
+
+    /// Convert a configuration into compact items
+    CompactConfig from_config_compact(std::istream& is) const override;
+
+    /// Parse a config file into compact items, from the memory mapped file when possible
+    CompactConfig from_file_compact(const std::string& name,
+            const std::function<bool(const std::string&)>& load_section) const override;
+
+    /// True for a ConfigBinary, not for a class derived from it
+    bool supports_compact() const override;
+
 private:
-    std::vector<ConfigItem> parse(const YAML::Node& node, std::vector<std::string> parents) const;
+    /// Decode a buffer, throw a ConfigError when it is not a valid binary configuration
+    static CompactConfig decode(const char* data, std::size_t size);
 };
 
 }
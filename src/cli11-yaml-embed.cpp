@@ -0,0 +1,141 @@
+// Compile a YAML configuration into a C++ header holding a CLI::StaticConfig, for the defaults of a program
+// that are fixed at build time: App::config_defaults then applies them without reading any file.
+//
+// Usage: cli11-yaml-embed <input.yaml> <output.hpp> <variable> [section]
+
+#include <cli11-yaml/cli11-yaml.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+/// A C++ string literal of a text, the characters other than the printable ones are written in octal
+std::string
+literal(std::string_view text)
+{
+    std::ostringstream out;
+    out << "std::string_view{\"";
+    for (char c: text) {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (byte < 0x20 || byte >= 0x7f || c == '?') {
+            // three octal digits always end the escape, '?' avoids the trigraphs
+            out << '\\' << std::oct << std::setw(3) << std::setfill('0') << static_cast<unsigned>(byte) << std::dec;
+        }
+        else {
+            out << c;
+        }
+    }
+    out << "\", " << text.size() << "}";
+    return out.str();
+}
+
+std::string
+value(const CLI::ConfigValue& value)
+{
+    static const char* types[] = {"none", "integer", "real", "boolean", "string"};
+    std::ostringstream out;
+    out << "CLI::ConfigValue{CLI::ConfigValue::value_type::" << types[static_cast<int>(value.type)] << ", ";
+    if (value.integer == std::numeric_limits<std::int64_t>::min()) {
+        out << "std::numeric_limits<std::int64_t>::min()";
+    }
+    else {
+        out << value.integer;
+    }
+    out << ", ";
+    if (value.real == std::numeric_limits<double>::infinity()) {
+        out << "std::numeric_limits<double>::infinity()";
+    }
+    else if (value.real == -std::numeric_limits<double>::infinity()) {
+        out << "-std::numeric_limits<double>::infinity()";
+    }
+    else {
+        // exact, as read back by the compiler
+        out << std::hexfloat << value.real << std::defaultfloat;
+    }
+    out << ", " << (value.boolean ? "true" : "false") << "}";
+    return out.str();
+}
+
+void
+write_header(std::ostream& out, const CLI::CompactConfig& config, const std::string& source, const std::string& variable)
+{
+    out << "// Generated by cli11-yaml-embed from " << source << ", do not edit\n"
+        << "#pragma once\n\n"
+        << "#include <CLI/CLI.hpp>\n\n"
+        << "#include <array>\n"
+        << "#include <cstdint>\n"
+        << "#include <limits>\n"
+        << "#include <string_view>\n\n";
+
+    out << "inline constexpr std::array<CLI::StaticConfig::Section, " << config.path_count() - 1 << "> " << variable
+        << "_sections{{\n";
+    for (CLI::CompactConfig::path_id path = 1; path < config.path_count(); ++path) {
+        out << "    {" << config.parent(path) << ", " << literal(config.name(path)) << "},\n";
+    }
+    out << "}};\n\n";
+
+    std::size_t input_count = 0;
+    out << "inline constexpr std::array<CLI::StaticConfig::Item, " << config.size() << "> " << variable
+        << "_items{{\n";
+    for (const auto& item: config.items()) {
+        out << "    {" << item.path << ", " << literal(item.name) << ", " << input_count << ", " << item.input_count
+            << ", " << value(item.value) << "},\n";
+        input_count += item.input_count;
+    }
+    out << "}};\n\n";
+
+    out << "inline constexpr std::array<std::string_view, " << input_count << "> " << variable << "_inputs{{\n";
+    for (const auto& item: config.items()) {
+        for (std::uint32_t i = 0; i < item.input_count; ++i) {
+            out << "    " << literal(config.inputs(item)[i]) << ",\n";
+        }
+    }
+    out << "}};\n\n";
+
+    out << "inline constexpr CLI::StaticConfig " << variable << "{\n"
+        << "    " << variable << "_sections.data(), " << variable << "_sections.size(),\n"
+        << "    " << variable << "_items.data(), " << variable << "_items.size(),\n"
+        << "    " << variable << "_inputs.data(), " << variable << "_inputs.size()};\n";
+}
+
+}
+
+int
+main(int argc, char** argv)
+{
+    if (argc < 4 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <input.yaml> <output.hpp> <variable> [section]" << std::endl;
+        return 1;
+    }
+
+    try {
+        CLI::ConfigYAML yaml;
+        if (argc == 5) {
+            yaml.section(argv[4]);
+        }
+        // the paths are interned from the items, only the sections holding items are written
+        CLI::CompactConfig config{yaml.from_file(argv[1])};
+
+        std::ostringstream header;
+        write_header(header, config, argv[1], argv[3]);
+        std::ofstream out{argv[2]};
+        out << header.str();
+        if (!out.good()) {
+            std::cerr << argv[0] << ": cannot write " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,110 +1,3680 @@
 #include <cli11-yaml/cli11-yaml.hpp>
 
+#include <yaml-cpp/eventhandler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
+
 namespace CLI {
 
+namespace {
+
+/// Check if a text is a decimal integer without leading zero, the only form read the same by YAML and lexical_cast
+bool
+is_decimal_integer(const char* begin, const char* end)
+{
+    if (begin != end && *begin == '-') {
+        ++begin;
+    }
+    if (begin == end || (*begin == '0' && end - begin > 1)) {
+        return false;
+    }
+    return std::all_of(begin, end, [](char c) { return c >= '0' && c <= '9'; });
+}
+
+/// Check if a text is a decimal real number, with a fraction or an exponent
+bool
+is_decimal_real(const std::string& text)
+{
+    auto exponent = text.find_first_of("eE");
+    auto mantissa_end = exponent == std::string::npos ? text.size() : exponent;
+    auto dot = text.find('.');
+    if (dot != std::string::npos && dot > mantissa_end) {
+        return false;
+    }
+    auto integer_end = dot == std::string::npos ? mantissa_end : dot;
+    if (dot == std::string::npos && exponent == std::string::npos) {
+        return false;
+    }
+    if (!is_decimal_integer(text.data(), text.data() + integer_end)) {
+        return false;
+    }
+    if (dot != std::string::npos && !std::all_of(text.begin() + static_cast<std::ptrdiff_t>(dot) + 1,
+            text.begin() + static_cast<std::ptrdiff_t>(mantissa_end), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    if (exponent != std::string::npos) {
+        auto digits = exponent + 1;
+        if (digits < text.size() && (text[digits] == '+' || text[digits] == '-')) {
+            ++digits;
+        }
+        if (digits == text.size() || !std::all_of(text.begin() + static_cast<std::ptrdiff_t>(digits), text.end(),
+                [](char c) { return c >= '0' && c <= '9'; })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The typed value of a scalar, only the plain scalars can be numbers or booleans, the quoted ones are strings
+ConfigValue
+scalar_value(const std::string& tag, const std::string& text)
+{
+    ConfigValue value;
+    if (tag == "!" || tag == "tag:yaml.org,2002:str") {
+        value.type = ConfigValue::value_type::string;
+        return value;
+    }
+    if (tag != "?") {
+        return value;
+    }
+
+    if (text == "true" || text == "True" || text == "TRUE" || text == "false" || text == "False" || text == "FALSE") {
+        value.type = ConfigValue::value_type::boolean;
+        value.boolean = text.front() == 't' || text.front() == 'T';
+    }
+    else if (is_decimal_integer(text.data(), text.data() + text.size())) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value.integer);
+        value.type = result.ec == std::errc{} ? ConfigValue::value_type::integer : ConfigValue::value_type::string;
+    }
+    else if (is_decimal_real(text)) {
+        // converted as lexical_cast does, so the variables get the same value from the text or the typed value
+        value.type = ConfigValue::value_type::real;
+        value.real = static_cast<double>(std::strtold(text.c_str(), nullptr));
+    }
+    else {
+        value.type = ConfigValue::value_type::string;
+    }
+    return value;
+}
+
+/// Read the rest of a stream into a string, by blocks rather than one character at a time
+std::string
+read_all(std::istream& is)
+{
+    std::string text;
+    char block[16384];
+    while (is.read(block, sizeof(block)) || is.gcount() > 0) {
+        text.append(block, static_cast<std::size_t>(is.gcount()));
+    }
+    return text;
+}
+
+// --------------------------------------------------------------------------
+/// The limits of a document read by ConfigYAML, 0 for no limit, a ConfigError is thrown at the first one exceeded
+class Limits {
+public:
+    Limits(std::size_t depth, std::size_t items, std::size_t sequence, std::size_t scalar) :
+            depth_(depth), items_(items), sequence_(sequence), scalar_(scalar)
+    {
+    }
+
+    bool
+    active() const { return depth_ != 0 || items_ != 0 || sequence_ != 0 || scalar_ != 0; }
+
+    bool
+    counts_items() const { return items_ != 0; }
+
+    void
+    depth(std::size_t depth, std::size_t line) const { check(depth, depth_, "more nesting levels than ", "", line); }
+
+    void
+    items(std::size_t items, std::size_t line) const { check(items, items_, "more values than ", "", line); }
+
+    void
+    sequence(std::size_t length, std::size_t line) const
+    {
+        check(length, sequence_, "a sequence longer than ", " elements", line);
+    }
+
+    void
+    scalar(std::size_t size, std::size_t line) const { check(size, scalar_, "a scalar larger than ", " bytes", line); }
+
+private:
+    static void
+    check(std::size_t value, std::size_t limit, const char* what, const char* unit, std::size_t line)
+    {
+        if (limit != 0 && value > limit) {
+            throw ConfigError("YAML: " + std::string(what) + std::to_string(limit) + unit + " at line "
+                              + std::to_string(line));
+        }
+    }
+
+    std::size_t depth_;
+    std::size_t items_;
+    std::size_t sequence_;
+    std::size_t scalar_;
+};
+
+// --------------------------------------------------------------------------
+/// Check the limits on the parser events, before giving them to the next handler when there is one: a document
+/// is rejected as soon as a limit is exceeded, before the rest of it is read
+/// An alias counts the values and the depth of its anchored node again, as the conversion repeats them
+class LimitHandler : public YAML::EventHandler {
+public:
+    explicit LimitHandler(const Limits& limits, YAML::EventHandler* next = nullptr) : limits_(limits), next_(next) {}
+
+    void
+    OnDocumentStart(const YAML::Mark& mark) override
+    {
+        if (next_ != nullptr) {
+            next_->OnDocumentStart(mark);
+        }
+    }
+
+    void
+    OnDocumentEnd() override
+    {
+        if (next_ != nullptr) {
+            next_->OnDocumentEnd();
+        }
+    }
+
+    void
+    OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override
+    {
+        start(mark, anchor, false, false);
+        if (next_ != nullptr) {
+            next_->OnNull(mark, anchor);
+        }
+    }
+
+    void
+    OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override
+    {
+        auto found = anchored_.find(anchor);
+        if (found != anchored_.end()) {
+            bool key = position(mark);
+            auto line = mark.line + 1;
+            auto depth = frames_.size() + found->second.depth;
+            limits_.depth(depth, static_cast<std::size_t>(line));
+            deepen(depth);
+            items_ += found->second.items - (key ? 1 : 0);
+            limits_.items(items_, static_cast<std::size_t>(line));
+        }
+        if (next_ != nullptr) {
+            next_->OnAlias(mark, anchor);
+        }
+    }
+
+    void
+    OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override
+    {
+        limits_.scalar(value.size(), static_cast<std::size_t>(mark.line + 1));
+        start(mark, anchor, false, false);
+        if (next_ != nullptr) {
+            next_->OnScalar(mark, tag, anchor, value);
+        }
+    }
+
+    void
+    OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+            YAML::EmitterStyle::value style) override
+    {
+        start(mark, anchor, true, false);
+        if (next_ != nullptr) {
+            next_->OnSequenceStart(mark, tag, anchor, style);
+        }
+    }
+
+    void
+    OnSequenceEnd() override
+    {
+        end();
+        if (next_ != nullptr) {
+            next_->OnSequenceEnd();
+        }
+    }
+
+    void
+    OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+            YAML::EmitterStyle::value style) override
+    {
+        start(mark, anchor, true, true);
+        if (next_ != nullptr) {
+            next_->OnMapStart(mark, tag, anchor, style);
+        }
+    }
+
+    void
+    OnMapEnd() override
+    {
+        end();
+        if (next_ != nullptr) {
+            next_->OnMapEnd();
+        }
+    }
+
+private:
+    struct Frame {
+        bool map;
+        /// the next node of a map is a key
+        bool key;
+        std::size_t length;
+    };
+
+    /// The values and the levels of an anchored node
+    struct Anchored {
+        std::size_t items;
+        std::size_t depth;
+    };
+
+    /// An anchored node being read
+    struct Open {
+        YAML::anchor_t anchor;
+        /// the depth of the node, the number of values before it
+        std::size_t depth;
+        std::size_t items;
+        std::size_t deepest;
+    };
+
+    /// Count a node in its collection, true for a key, which is not a value
+    bool
+    position(const YAML::Mark& mark)
+    {
+        if (frames_.empty()) {
+            return false;
+        }
+        Frame& frame = frames_.back();
+        if (frame.map) {
+            frame.key = !frame.key;
+            return !frame.key;
+        }
+        limits_.sequence(++frame.length, static_cast<std::size_t>(mark.line + 1));
+        return false;
+    }
+
+    void
+    start(const YAML::Mark& mark, YAML::anchor_t anchor, bool collection, bool map)
+    {
+        auto line = static_cast<std::size_t>(mark.line + 1);
+        auto before = items_;
+        // the keys are counted as values by the anchors only
+        if (!position(mark)) {
+            limits_.items(++items_, line);
+        }
+        else {
+            before = items_ - 1;
+        }
+        if (collection) {
+            frames_.push_back({map, true, 0});
+            limits_.depth(frames_.size(), line);
+            deepen(frames_.size());
+        }
+        if (anchor != YAML::NullAnchor && collection) {
+            open_.push_back({anchor, frames_.size(), before, frames_.size()});
+        }
+        else if (anchor != YAML::NullAnchor) {
+            anchored_[anchor] = Anchored{items_ - before, 0};
+        }
+    }
+
+    void
+    end()
+    {
+        if (!open_.empty() && open_.back().depth == frames_.size()) {
+            finish();
+        }
+        frames_.pop_back();
+    }
+
+    /// Keep the values and the levels of the anchored collection just read
+    void
+    finish()
+    {
+        const Open& node = open_.back();
+        anchored_[node.anchor] = Anchored{items_ - node.items, node.deepest - node.depth + 1};
+        open_.pop_back();
+    }
+
+    /// The anchored nodes being read reach a depth
+    void
+    deepen(std::size_t depth)
+    {
+        for (auto& node: open_) {
+            node.deepest = std::max(node.deepest, depth);
+        }
+    }
+
+    const Limits& limits_;
+    YAML::EventHandler* next_;
+    std::vector<Frame> frames_;
+    std::vector<Open> open_;
+    std::unordered_map<YAML::anchor_t, Anchored> anchored_;
+    std::size_t items_{0};
+};
+
+// --------------------------------------------------------------------------
+/// Build the ConfigItems from the parser events, producing the same items as ConfigYAML::parse
+class ConfigYAMLHandler : public YAML::EventHandler {
+public:
+    explicit ConfigYAMLHandler(std::vector<ConfigItem>& output) : output_(output) {}
+
+    /// Only convert the map at a path of keys, or the maps of a sequence at this path (all of them for a negative index)
+    /// The top level sections rejected by load_section are skipped as well
+    ConfigYAMLHandler(std::vector<ConfigItem>& output, std::vector<std::string> section, int index,
+            const std::function<bool(const std::string&)>* load_section = nullptr) :
+            output_(output), section_(std::move(section)), index_(index), load_section_(load_section)
+    {
+    }
+
+    void OnDocumentStart(const YAML::Mark&) override {}
+    void OnDocumentEnd() override {}
+
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override
+    {
+        record({Event::Null, mark, anchor, {}});
+        if (skip(Event::Null, "null")) {
+            return;
+        }
+
+        if (!stack_.empty() && stack_.back().kind == Frame::Map) {
+            if (stack_.back().expect_key) {
+                // same as YAML::Node::as<std::string>() on a null key
+                key_ = "null";
+            }
+            stack_.back().expect_key = !stack_.back().expect_key;
+        }
+    }
+
+    void OnAlias(const YAML::Mark&, YAML::anchor_t anchor) override
+    {
+        // Replay the events of the anchored node, as YAML::Load would share the node
+        auto it = anchors_.find(anchor);
+        if (it == anchors_.end()) {
+            return;
+        }
+        for (const auto& event: it->second) {
+            switch (event.type) {
+                case Event::Null: OnNull(event.mark, YAML::NullAnchor); break;
+                case Event::Scalar: OnScalar(event.mark, event.tag, YAML::NullAnchor, event.value); break;
+                case Event::SequenceStart: OnSequenceStart(event.mark, "", YAML::NullAnchor, YAML::EmitterStyle::Default); break;
+                case Event::SequenceEnd: OnSequenceEnd(); break;
+                case Event::MapStart: OnMapStart(event.mark, "", YAML::NullAnchor, YAML::EmitterStyle::Default); break;
+                case Event::MapEnd: OnMapEnd(); break;
+            }
+        }
+    }
+
+    void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override
+    {
+        record({Event::Scalar, mark, anchor, value, tag});
+        if (skip(Event::Scalar, value)) {
+            return;
+        }
+
+        if (stack_.empty()) {
+            return;
+        }
+        Frame& frame = stack_.back();
+        if (frame.kind == Frame::Sequence) {
+            frame.item.inputs.push_back(value);
+        }
+        else if (frame.expect_key) {
+            key_ = value;
+            frame.expect_key = false;
+        }
+        else {
+            ConfigItem config_item;
+            config_item.name = key_;
+            config_item.parents = parents_;
+            config_item.inputs.push_back(value);
+            config_item.value = scalar_value(tag, value);
+            output_.push_back(std::move(config_item));
+            frame.expect_key = true;
+        }
+    }
+
+    void OnSequenceStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value) override
+    {
+        record({Event::SequenceStart, mark, anchor, {}});
+        if (skip(Event::SequenceStart)) {
+            return;
+        }
+
+        Frame frame{Frame::Sequence};
+        if (!stack_.empty() && stack_.back().kind == Frame::Map) {
+            open_value(mark);
+            frame.owns_path = true;
+        }
+        frame.item.name = parents_.empty() ? "" : *parents_.rbegin();
+        frame.item.parents = parents_;
+        if (!frame.item.parents.empty())
+            frame.item.parents.pop_back();
+        stack_.push_back(std::move(frame));
+    }
+
+    void OnSequenceEnd() override
+    {
+        record({Event::SequenceEnd, {}, YAML::NullAnchor, {}});
+        if (skip(Event::SequenceEnd)) {
+            return;
+        }
+
+        output_.push_back(std::move(stack_.back().item));
+        close_frame();
+    }
+
+    void OnMapStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value) override
+    {
+        record({Event::MapStart, mark, anchor, {}});
+        if (skip(Event::MapStart)) {
+            return;
+        }
+
+        Frame frame{Frame::Map};
+        if (!stack_.empty() && stack_.back().kind == Frame::Map) {
+            open_value(mark);
+            frame.owns_path = true;
+            frame.section = true; // Only Map start a section (not a sequence)
+
+            ConfigItem config_item_open;
+            config_item_open.name = "++";
+            config_item_open.parents = parents_;
+            output_.push_back(std::move(config_item_open));
+        }
+        stack_.push_back(std::move(frame));
+    }
+
+    void OnMapEnd() override
+    {
+        record({Event::MapEnd, {}, YAML::NullAnchor, {}});
+        if (skip(Event::MapEnd)) {
+            return;
+        }
+
+        if (stack_.back().section) { // Only Map end a section (not a sequence)
+            if (!output_.empty() && output_.rbegin()->name == "++") {
+                output_.pop_back();
+            }
+            else {
+                ConfigItem config_item_close;
+                config_item_close.name = "--";
+                config_item_close.parents = parents_;
+                output_.push_back(std::move(config_item_close));
+            }
+        }
+        close_frame();
+    }
+
+private:
+    struct Frame {
+        enum Kind { Map, Sequence } kind;
+        /// the frame pushed its key on the parents stack
+        bool owns_path{false};
+        /// the map opened a "++" section
+        bool section{false};
+        /// the next event in the map is a key
+        bool expect_key{true};
+        /// the item collecting the scalars of a sequence
+        ConfigItem item{};
+    };
+
+    struct Event {
+        enum Type { Null, Scalar, SequenceStart, SequenceEnd, MapStart, MapEnd } type;
+        YAML::Mark mark;
+        YAML::anchor_t anchor;
+        std::string value;
+        std::string tag{};
+    };
+
+    struct Recording {
+        YAML::anchor_t anchor;
+        std::size_t depth;
+        std::vector<Event> events;
+    };
+
+    /// Navigation in the maps above the selected section
+    struct Selection {
+        enum Kind { Map, Sequence } kind;
+        /// index of the key of the section to match in this map
+        std::size_t level;
+        /// the next event in the map is a key
+        bool expect_key{true};
+        /// the current key is the one of the section
+        bool match{false};
+        /// number of elements seen in the sequence of the section
+        int elements{0};
+    };
+
+    /// Check if an event is outside of the selected section, only its nesting is then followed
+    bool skip(Event::Type type, const std::string& value = {})
+    {
+        bool start = type == Event::SequenceStart || type == Event::MapStart;
+        bool end = type == Event::SequenceEnd || type == Event::MapEnd;
+
+        if (skipped_ > 0) {
+            skipped_ += start ? 1 : end ? -1 : 0;
+            return true;
+        }
+        if (section_.empty() || inside_ > 0) {
+            if (load_section_ != nullptr && type == Event::MapStart && stack_.size() == 1
+                    && stack_.back().kind == Frame::Map && !stack_.back().expect_key && !(*load_section_)(key_)) {
+                stack_.back().expect_key = true;
+                skipped_ = 1;
+                return true;
+            }
+            if (inside_ > 0) {
+                inside_ += start ? 1 : end ? -1 : 0;
+            }
+            return false;
+        }
+        if (end) {
+            selection_.pop_back();
+            return true;
+        }
+        if (selection_.empty()) {
+            if (type == Event::MapStart) {
+                selection_.push_back({Selection::Map, 0});
+            }
+            else if (start) {
+                skipped_ = 1;
+            }
+            return true;
+        }
+
+        Selection& current = selection_.back();
+        if (current.kind == Selection::Sequence) {
+            int element = current.elements++;
+            if (type == Event::MapStart && (index_ < 0 || element == index_)) {
+                inside_ = 1;
+                return false;
+            }
+        }
+        else if (current.expect_key) {
+            current.expect_key = false;
+            current.match = type == Event::Scalar && value == section_[current.level];
+        }
+        else {
+            current.expect_key = true;
+            if (current.match && current.level + 1 < section_.size() && type == Event::MapStart) {
+                selection_.push_back({Selection::Map, current.level + 1});
+                return true;
+            }
+            if (current.match && current.level + 1 == section_.size()) {
+                if (type == Event::MapStart) {
+                    inside_ = 1;
+                    return false;
+                }
+                if (type == Event::SequenceStart) {
+                    selection_.push_back({Selection::Sequence, current.level});
+                    return true;
+                }
+            }
+        }
+        if (start) {
+            skipped_ = 1;
+        }
+        return true;
+    }
+
+    /// A collection is used as the value of the current map key
+    void open_value(const YAML::Mark& mark)
+    {
+        Frame& parent = stack_.back();
+        if (parent.expect_key) {
+            // complex keys cannot be converted into a name, as with YAML::Node::as<std::string>()
+            throw YAML::TypedBadConversion<std::string>(mark);
+        }
+        parent.expect_key = true;
+        parents_.push_back(key_);
+    }
+
+    void close_frame()
+    {
+        if (stack_.back().owns_path) {
+            parents_.pop_back();
+        }
+        stack_.pop_back();
+    }
+
+    /// Keep the events of the anchored nodes so aliases can be replayed
+    void record(Event event)
+    {
+        bool start = event.type == Event::SequenceStart || event.type == Event::MapStart;
+        bool end = event.type == Event::SequenceEnd || event.type == Event::MapEnd;
+
+        if (event.anchor != YAML::NullAnchor) {
+            recordings_.push_back({event.anchor, 0, {}});
+        }
+        for (auto& recording: recordings_) {
+            recording.events.push_back(event);
+            if (start) {
+                ++recording.depth;
+            }
+            else if (end) {
+                --recording.depth;
+            }
+        }
+        while (!recordings_.empty() && recordings_.back().depth == 0) {
+            anchors_[recordings_.back().anchor] = std::move(recordings_.back().events);
+            recordings_.pop_back();
+        }
+    }
+
+    std::vector<ConfigItem>& output_;
+    std::vector<Frame> stack_;
+    std::vector<std::string> parents_;
+    std::string key_;
+    std::vector<Recording> recordings_;
+    std::map<YAML::anchor_t, std::vector<Event>> anchors_;
+
+    std::vector<std::string> section_;
+    int index_{-1};
+    const std::function<bool(const std::string&)>* load_section_{nullptr};
+    std::vector<Selection> selection_;
+    /// nesting depth in the selected section
+    int inside_{0};
+    /// nesting depth in a collection outside of the section
+    int skipped_{0};
+};
+
+// --------------------------------------------------------------------------
+/// Write an app through an emitter, following the layout of ConfigBase::to_config
+/// Subcommands are nested maps, only opened when one of their options has a value to write
+template <typename Emitter>
+class ConfigWriter {
+public:
+    ConfigWriter(std::ostream& out, bool default_also, bool write_description) :
+            emitter_(out), default_also_(default_also), write_description_(write_description)
+    {
+    }
+
+    void
+    write(const App* app, std::vector<std::string> path)
+    {
+        comment(app);
+        emitter_.begin_map();
+        pending_ = std::move(path);
+        auto opened = pending_.size();
+        write_app(app);
+        if (pending_.empty()) {
+            for (std::size_t i = 0; i < opened; ++i) {
+                emitter_.end_map();
+            }
+        }
+        emitter_.end_map();
+    }
+
+private:
+    void
+    comment(const App* app)
+    {
+        if (write_description_ && (app->get_configurable() || app->get_parent() == nullptr || app->get_name().empty())) {
+            comment(app->get_description());
+        }
+    }
+
+    void
+    comment(std::string text)
+    {
+        detail::rtrim(text);
+        if (!text.empty()) {
+            emitter_.comment(text);
+        }
+    }
+
+    /// Open the maps of the subcommands that did not write anything yet
+    void
+    open_pending()
+    {
+        for (const auto& name: pending_) {
+            emitter_.key(name);
+            emitter_.begin_map();
+        }
+        pending_.clear();
+    }
+
+    void
+    write_app(const App* app)
+    {
+        std::vector<std::string> groups = app->get_groups();
+        bool defaultUsed = false;
+        groups.insert(groups.begin(), std::string("Options"));
+        for (auto& group: groups) {
+            if (group == "Options" || group.empty()) {
+                if (defaultUsed) {
+                    continue;
+                }
+                defaultUsed = true;
+            }
+            bool groupUsed = false;
+            for (const Option* opt: app->get_options({})) {
+                // Only process options that are configurable
+                if (!opt->get_configurable()) {
+                    continue;
+                }
+                if (opt->get_group() != group) {
+                    if (!(group == "Options" && opt->get_group().empty())) {
+                        continue;
+                    }
+                }
+                if (!groupUsed && write_description_ && group != "Options" && !group.empty()) {
+                    open_pending();
+                    emitter_.newline();
+                    comment(group + " Options");
+                }
+                groupUsed = write_option(opt) || groupUsed;
+            }
+        }
+
+        auto subcommands = app->get_subcommands({});
+        for (const App* subcom: subcommands) {
+            if (subcom->get_name().empty()) {
+                if (write_description_ && !subcom->get_group().empty()) {
+                    open_pending();
+                    emitter_.newline();
+                    comment(subcom->get_group() + " Options");
+                }
+                if (write_description_ && !subcom->get_description().empty()) {
+                    open_pending();
+                    emitter_.newline();
+                    comment(subcom);
+                }
+                write_app(subcom);
+            }
+        }
+
+        for (const App* subcom: subcommands) {
+            if (!subcom->get_name().empty()) {
+                auto depth = pending_.size();
+                if (write_description_ && subcom->get_configurable() && !subcom->get_description().empty()) {
+                    open_pending();
+                    emitter_.key(subcom->get_name());
+                    comment(subcom);
+                    emitter_.begin_map();
+                }
+                else {
+                    pending_.push_back(subcom->get_name());
+                }
+                write_app(subcom);
+                if (pending_.size() > depth) {
+                    pending_.pop_back();
+                }
+                else {
+                    emitter_.end_map();
+                }
+            }
+        }
+    }
+
+    bool
+    write_option(const Option* opt)
+    {
+        std::vector<std::string> values = opt->reduced_results();
+        std::string name = opt->get_single_name();
+
+        if (values.empty() && default_also_) {
+            const std::string& default_str = opt->get_default_str();
+            if (!default_str.empty()) {
+                if (opt->get_items_expected_max() > 1 && default_str.size() >= 2 && default_str.front() == '['
+                        && default_str.back() == ']') {
+                    std::string joined = default_str.substr(1, default_str.size() - 2);
+                    if (!joined.empty()) {
+                        values = detail::split(joined, ',');
+                    }
+                    else {
+                        write_sequence(opt, name, values);
+                        return true;
+                    }
+                }
+                else {
+                    values.push_back(default_str);
+                }
+            }
+            else if (opt->get_expected_min() == 0) {
+                values.emplace_back("false");
+            }
+            else if (opt->get_run_callback_for_default()) {
+                values.emplace_back(); // empty string default value
+            }
+        }
+
+        if (values.empty()) {
+            return false;
+        }
+        if (values.size() == 1) {
+            if (!opt->get_fnames().empty()) {
+                values.front() = opt->get_flag_value(name, values.front());
+            }
+            open_pending();
+            emitter_.key(name);
+            emitter_.scalar(values.front());
+            if (write_description_ && opt->has_description()) {
+                comment(opt->get_description());
+            }
+        }
+        else {
+            write_sequence(opt, name, values);
+        }
+        return true;
+    }
+
+    void
+    write_sequence(const Option* opt, const std::string& name, const std::vector<std::string>& values)
+    {
+        open_pending();
+        emitter_.key(name);
+        if (write_description_ && opt->has_description()) {
+            comment(opt->get_description());
+        }
+        emitter_.begin_sequence();
+        for (const auto& value: values) {
+            emitter_.scalar(value);
+        }
+        emitter_.end_sequence();
+    }
+
+    Emitter emitter_;
+    bool default_also_;
+    bool write_description_;
+    /// Names of the nested subcommand maps entered but not written yet
+    std::vector<std::string> pending_;
+};
+
+// --------------------------------------------------------------------------
+/// Emitter of ConfigWriter writing YAML
+class YAMLEmitter {
+public:
+    explicit YAMLEmitter(std::ostream& out) : emitter_(out) {}
+
+    void
+    begin_map() { emitter_ << YAML::BeginMap; }
+
+    void
+    end_map() { emitter_ << YAML::EndMap; }
+
+    void
+    begin_sequence() { emitter_ << YAML::BeginSeq; }
+
+    void
+    end_sequence() { emitter_ << YAML::EndSeq; }
+
+    void
+    key(const std::string& name) { emitter_ << YAML::Key << name << YAML::Value; }
+
+    void
+    scalar(const std::string& value) { emitter_ << value; }
+
+    void
+    comment(const std::string& text) { emitter_ << YAML::Comment(text); }
+
+    void
+    newline() { emitter_ << YAML::Newline; }
+
+private:
+    YAML::Emitter emitter_;
+};
+
+// --------------------------------------------------------------------------
+/// Emitter of ConfigWriter writing JSON: the comments are dropped, the values that are JSON numbers or booleans
+/// are written as they are and the other ones as strings
+class JSONEmitter {
+public:
+    explicit JSONEmitter(std::ostream& out) : out_(out) {}
+
+    void
+    begin_map() { open('{'); }
+
+    void
+    end_map() { close('}'); }
+
+    void
+    begin_sequence() { open('['); }
+
+    void
+    end_sequence() { close(']'); }
+
+    void
+    key(const std::string& name)
+    {
+        separate();
+        string(name);
+        out_ << ": ";
+        keyed_ = true;
+    }
+
+    void
+    scalar(const std::string& value)
+    {
+        separate();
+        if (literal(value)) {
+            out_ << value;
+        }
+        else {
+            string(value);
+        }
+    }
+
+    void
+    comment(const std::string&) {}
+
+    void
+    newline() {}
+
+private:
+    /// Check if a value is written without quotes, as a JSON number or boolean
+    static bool
+    literal(const std::string& value)
+    {
+        if (value == "true" || value == "false") {
+            return true;
+        }
+        std::size_t pos = 0;
+        auto digits = [&value, &pos]() {
+            auto start = pos;
+            while (pos < value.size() && value[pos] >= '0' && value[pos] <= '9') {
+                ++pos;
+            }
+            return pos - start;
+        };
+        if (pos < value.size() && value[pos] == '-') {
+            ++pos;
+        }
+        auto integer = digits();
+        if (integer == 0 || (integer > 1 && value[pos - integer] == '0')) {
+            return false;
+        }
+        if (pos < value.size() && value[pos] == '.') {
+            ++pos;
+            if (digits() == 0) {
+                return false;
+            }
+        }
+        if (pos < value.size() && (value[pos] == 'e' || value[pos] == 'E')) {
+            ++pos;
+            if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) {
+                ++pos;
+            }
+            if (digits() == 0) {
+                return false;
+            }
+        }
+        return pos == value.size();
+    }
+
+    void
+    string(const std::string& text)
+    {
+        out_ << '"';
+        for (char c: text) {
+            switch (c) {
+                case '"':
+                    out_ << "\\\"";
+                    break;
+                case '\\':
+                    out_ << "\\\\";
+                    break;
+                case '\n':
+                    out_ << "\\n";
+                    break;
+                case '\r':
+                    out_ << "\\r";
+                    break;
+                case '\t':
+                    out_ << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        static const char hex[] = "0123456789abcdef";
+                        out_ << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+                    }
+                    else {
+                        out_ << c;
+                    }
+            }
+        }
+        out_ << '"';
+    }
+
+    /// A value follows its key on the same line, the other ones start a new line after a comma
+    void
+    separate()
+    {
+        if (keyed_) {
+            keyed_ = false;
+            return;
+        }
+        if (!counts_.empty()) {
+            if (counts_.back()++ > 0) {
+                out_ << ',';
+            }
+            out_ << '\n' << std::string(2 * counts_.size(), ' ');
+        }
+    }
+
+    void
+    open(char bracket)
+    {
+        separate();
+        out_ << bracket;
+        counts_.push_back(0);
+    }
+
+    void
+    close(char bracket)
+    {
+        auto count = counts_.back();
+        counts_.pop_back();
+        if (count > 0) {
+            out_ << '\n' << std::string(2 * counts_.size(), ' ');
+        }
+        out_ << bracket;
+        if (counts_.empty()) {
+            out_ << '\n';
+        }
+    }
+
+    std::ostream& out_;
+    /// the number of values written in each open object or array
+    std::vector<std::size_t> counts_;
+    bool keyed_{false};
+};
+
+// --------------------------------------------------------------------------
+/// Binary cache of the items parsed from a file
+/// The header holds the identity of the source file (path, size, modification time and content hash),
+/// followed by the items as length prefixed strings, all in the native byte order
+namespace item_cache {
+
+constexpr char magic[8] = {'C', 'L', 'I', 'Y', 'C', 'A', 'C', '3'};
+constexpr std::uint32_t byte_order = 0x01020304;
+
+struct Identity {
+    std::string path;
+    /// the settings of the ConfigYAML changing the items
+    std::string settings;
+    std::uint64_t size{0};
+    std::int64_t mtime{0};
+    std::uint64_t hash{0};
+};
+
+/// FNV-1a, only used to detect a changed content
+std::uint64_t
+hash(const char* data, std::size_t size)
+{
+    std::uint64_t value = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+class Writer {
+public:
+    template <typename T>
+    void
+    put(T value)
+    {
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void
+    put(const std::string& value)
+    {
+        put(static_cast<std::uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    void
+    put(const std::vector<std::string>& values)
+    {
+        put(static_cast<std::uint32_t>(values.size()));
+        for (const auto& value: values) {
+            put(value);
+        }
+    }
+
+    void
+    put(const ConfigValue& value)
+    {
+        put(static_cast<std::uint8_t>(value.type));
+        put(value.integer);
+        put(value.real);
+        put(static_cast<std::uint8_t>(value.boolean ? 1 : 0));
+    }
+
+    const std::string&
+    str() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+/// Bounds checked reader, a truncated or corrupted cache only fails the read
+class Reader {
+public:
+    Reader(const char* data, std::size_t size) : current_(data), end_(data + size) {}
+
+    template <typename T>
+    bool
+    get(T& value)
+    {
+        if (static_cast<std::size_t>(end_ - current_) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, current_, sizeof(T));
+        current_ += sizeof(T);
+        return true;
+    }
+
+    bool
+    get(std::string& value)
+    {
+        std::uint32_t size{0};
+        if (!get(size) || static_cast<std::size_t>(end_ - current_) < size) {
+            return false;
+        }
+        value.assign(current_, size);
+        current_ += size;
+        return true;
+    }
+
+    bool
+    get(std::vector<std::string>& values)
+    {
+        std::uint32_t count{0};
+        if (!get(count) || static_cast<std::size_t>(end_ - current_) < count * sizeof(std::uint32_t)) {
+            return false;
+        }
+        values.resize(count);
+        for (auto& value: values) {
+            if (!get(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool
+    get(ConfigValue& value)
+    {
+        std::uint8_t type{0};
+        std::uint8_t boolean{0};
+        if (!get(type) || type > static_cast<std::uint8_t>(ConfigValue::value_type::string) || !get(value.integer)
+                || !get(value.real) || !get(boolean)) {
+            return false;
+        }
+        value.type = static_cast<ConfigValue::value_type>(type);
+        value.boolean = boolean != 0;
+        return true;
+    }
+
+    bool
+    done() const { return current_ == end_; }
+
+private:
+    const char* current_;
+    const char* end_;
+};
+
+std::string
+serialize(const Identity& identity, const std::vector<ConfigItem>& items)
+{
+    Writer writer;
+    for (char c: magic) {
+        writer.put(c);
+    }
+    writer.put(byte_order);
+    writer.put(identity.path);
+    writer.put(identity.settings);
+    writer.put(identity.size);
+    writer.put(identity.mtime);
+    writer.put(identity.hash);
+    writer.put(static_cast<std::uint64_t>(items.size()));
+    for (const auto& item: items) {
+        writer.put(item.parents);
+        writer.put(item.name);
+        writer.put(item.inputs);
+        writer.put(item.value);
+    }
+    return writer.str();
+}
+
+bool
+deserialize(const std::string& buffer, const Identity& identity, std::vector<ConfigItem>& items)
+{
+    if (buffer.size() < sizeof(magic) || buffer.compare(0, sizeof(magic), magic, sizeof(magic)) != 0) {
+        return false;
+    }
+    Reader reader{buffer.data() + sizeof(magic), buffer.size() - sizeof(magic)};
+    Identity stored;
+    std::uint32_t order{0};
+    if (!reader.get(order) || order != byte_order || !reader.get(stored.path) || !reader.get(stored.settings)
+            || !reader.get(stored.size) || !reader.get(stored.mtime) || !reader.get(stored.hash)) {
+        return false;
+    }
+    if (stored.path != identity.path || stored.settings != identity.settings || stored.size != identity.size
+            || stored.mtime != identity.mtime || stored.hash != identity.hash) {
+        return false;
+    }
+    std::uint64_t count{0};
+    if (!reader.get(count) || count > buffer.size()) {
+        return false;
+    }
+    items.resize(static_cast<std::size_t>(count));
+    for (auto& item: items) {
+        if (!reader.get(item.parents) || !reader.get(item.name) || !reader.get(item.inputs) || !reader.get(item.value)) {
+            return false;
+        }
+    }
+    return reader.done();
+}
+
+/// Name of the cache file of a source file, from the hash of its absolute path
+std::filesystem::path
+location(const std::string& directory, const std::string& path)
+{
+    std::ostringstream name;
+    name << std::hex << hash(path.data(), path.size()) << ".yaml-cache";
+    return std::filesystem::path{directory} / name.str();
+}
+
+bool
+load(const std::filesystem::path& file, const Identity& identity, std::vector<ConfigItem>& items)
+{
+    std::ifstream input{file, std::ios::binary | std::ios::ate};
+    if (!input.good()) {
+        return false;
+    }
+    std::string buffer(static_cast<std::size_t>(input.tellg()), '\0');
+    input.seekg(0);
+    if (!input.read(&buffer[0], static_cast<std::streamsize>(buffer.size()))) {
+        return false;
+    }
+    if (!deserialize(buffer, identity, items)) {
+        items.clear();
+        return false;
+    }
+    return true;
+}
+
+/// Write to a temporary file renamed over the cache, so concurrent readers never see a partial cache
+/// Failing to write the cache is not an error, the file is simply parsed again next time
+void
+store(const std::filesystem::path& file, const Identity& identity, const std::vector<ConfigItem>& items)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+
+    auto unique = std::hash<std::thread::id>{}(std::this_thread::get_id())
+            ^ static_cast<std::size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::filesystem::path tmp = file;
+    tmp += ".tmp" + std::to_string(unique);
+    {
+        std::ofstream output{tmp, std::ios::binary | std::ios::trunc};
+        std::string buffer = serialize(identity, items);
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!output.good()) {
+            output.close();
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, file, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+}
+
+// --------------------------------------------------------------------------
+/// Layout of the files of ConfigBinary, in the byte order of the host writing them: the header, the string table
+/// (each string is its 32 bit length and its bytes), the sections after the root (index of the parent and offset
+/// of the name), the items (index of the section, offset of the name, range of the inputs and typed value) and the
+/// inputs (offsets of the strings)
+namespace binary_config {
+
+constexpr char magic[8] = {'C', 'L', 'I', 'Y', 'C', 'F', 'B', '1'};
+constexpr std::uint32_t byte_order = 0x01020304;
+
+/// The strings of a file, each one written once, the views must outlive the table
+class StringTable {
+public:
+    std::uint32_t
+    add(std::string_view text)
+    {
+        auto found = offsets_.find(text);
+        if (found != offsets_.end()) {
+            return found->second;
+        }
+        auto offset = static_cast<std::uint32_t>(writer_.str().size());
+        writer_.put(static_cast<std::uint32_t>(text.size()));
+        for (char c: text) {
+            writer_.put(c);
+        }
+        offsets_.emplace(text, offset);
+        return offset;
+    }
+
+    const std::string&
+    str() const { return writer_.str(); }
+
+private:
+    item_cache::Writer writer_;
+    std::unordered_map<std::string_view, std::uint32_t> offsets_;
+};
+
+}
+
+// --------------------------------------------------------------------------
+/// Output of ConfigYAML::parse into a list of ConfigItem, each item holds a copy of its parents
+class ItemOutput {
+public:
+    /// The items of the parts of a document converted on their own, see ConfigYAML::parallel
+    static constexpr bool splittable = true;
+    using Part = std::vector<ConfigItem>;
+
+    explicit ItemOutput(std::vector<ConfigItem>& items) : items_(items) {}
+
+    /// Add the items of the next part of the document
+    void
+    append(Part&& part)
+    {
+        items_.insert(items_.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+    }
+
+    void
+    enter(const std::string&) {}
+
+    void
+    leave() {}
+
+    void
+    value(const std::vector<std::string>& parents, std::string name, const std::string& input, const std::string& tag)
+    {
+        ConfigItem& item = items_.emplace_back();
+        item.name = std::move(name);
+        item.parents = parents;
+        item.inputs.push_back(input);
+        item.value = scalar_value(tag, input);
+    }
+
+    /// The item of a sequence, named after the last parent
+    void
+    sequence(const std::vector<std::string>& parents, const std::vector<const std::string*>& inputs)
+    {
+        ConfigItem& item = items_.emplace_back();
+        if (!parents.empty()) {
+            item.name = parents.back();
+            item.parents.assign(parents.begin(), std::prev(parents.end()));
+        }
+        item.inputs.reserve(inputs.size());
+        for (const auto* input: inputs) {
+            item.inputs.push_back(*input);
+        }
+    }
+
+    void
+    open(const std::vector<std::string>& parents)
+    {
+        ConfigItem& item = items_.emplace_back();
+        item.name = "++";
+        item.parents = parents;
+    }
+
+    /// Close a section, an empty one is dropped
+    void
+    close(const std::vector<std::string>& parents)
+    {
+        if (!items_.empty() && items_.back().name == "++") {
+            items_.pop_back();
+        }
+        else {
+            ConfigItem& item = items_.emplace_back();
+            item.name = "--";
+            item.parents = parents;
+        }
+    }
+
+    /// The maps are converted again for each of their aliases
+    bool
+    repeat(const YAML::Node&) { return false; }
+
+    std::size_t
+    position() const { return 0; }
+
+    void
+    record(const YAML::Node&, std::size_t) {}
+
+    /// Add the items built by the streaming handler
+    void
+    add_items(std::vector<ConfigItem>&& items) { append(std::move(items)); }
+
+private:
+    std::vector<ConfigItem>& items_;
+};
+
+// --------------------------------------------------------------------------
+/// Output of ConfigYAML::parse into a CompactConfig, the path of the current section is interned when entered
+class CompactOutput {
+public:
+    static constexpr bool splittable = true;
+    using Part = CompactConfig;
+
+    explicit CompactOutput(CompactConfig& items) : items_(items) {}
+
+    /// Add the items of the next part of the document, its strings are not copied
+    void
+    append(Part&& part) { items_.append(std::move(part)); }
+
+    void
+    enter(const std::string& name) { paths_.push_back(items_.path(paths_.back(), name)); }
+
+    void
+    leave() { paths_.pop_back(); }
+
+    void
+    value(const std::vector<std::string>&, const std::string& name, const std::string& input, const std::string& tag)
+    {
+        items_.add(paths_.back(), name);
+        items_.add_input(input);
+        items_.set_value(scalar_value(tag, input));
+    }
+
+    void
+    sequence(const std::vector<std::string>& parents, const std::vector<const std::string*>& inputs)
+    {
+        if (parents.empty()) {
+            items_.add(CompactConfig::root, {});
+        }
+        else {
+            items_.add(items_.parent(paths_.back()), parents.back());
+        }
+        for (const auto* input: inputs) {
+            items_.add_input(*input);
+        }
+    }
+
+    void
+    open(const std::vector<std::string>&) { items_.add(paths_.back(), "++"); }
+
+    void
+    close(const std::vector<std::string>&)
+    {
+        if (!items_.empty() && items_.back().name == "++") {
+            items_.pop_back();
+        }
+        else {
+            items_.add(paths_.back(), "--");
+        }
+    }
+
+    /// Add again the items of a map already converted when the node is one of its aliases, under the current
+    /// path: the names and inputs stay in the arena, only the items and the paths below the map are added
+    bool
+    repeat(const YAML::Node& node)
+    {
+        auto range = maps_.equal_range(node.Mark().pos);
+        for (auto it = range.first; it != range.second; ++it) {
+            const Converted& map = it->second;
+            if (!map.node.is(node)) {
+                continue;
+            }
+            std::unordered_map<CompactConfig::path_id, CompactConfig::path_id> paths{{map.path, paths_.back()}};
+            for (std::size_t index = map.first; index < map.last; ++index) {
+                CompactConfig::Item item = items_.items()[index];
+                items_.repeat(relocate(paths, item.path), item);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    std::size_t
+    position() const { return items_.size(); }
+
+    /// Remember the items given for a map from `first`, the nodes are found again by their position in the
+    /// document, yaml-cpp shares the node of an anchor with all its aliases
+    void
+    record(const YAML::Node& node, std::size_t first)
+    {
+        if (items_.size() > first) {
+            maps_.emplace(node.Mark().pos, Converted{node, paths_.back(), first, items_.size()});
+        }
+    }
+
+    /// Add the items built by the streaming handler
+    void
+    add_items(std::vector<ConfigItem>&& items) { items_.append(CompactConfig(items)); }
+
+private:
+    struct Converted {
+        YAML::Node node;
+        CompactConfig::path_id path;
+        std::size_t first;
+        std::size_t last;
+    };
+
+    /// The path of an alias for a path below the map, the sections are interned on the first use
+    CompactConfig::path_id
+    relocate(std::unordered_map<CompactConfig::path_id, CompactConfig::path_id>& paths, CompactConfig::path_id path)
+    {
+        auto found = paths.find(path);
+        if (found != paths.end()) {
+            return found->second;
+        }
+        auto relocated = items_.path(relocate(paths, items_.parent(path)), items_.name(path));
+        paths.emplace(path, relocated);
+        return relocated;
+    }
+
+    CompactConfig& items_;
+    std::vector<CompactConfig::path_id> paths_{CompactConfig::root};
+    std::unordered_multimap<std::size_t, Converted> maps_;
+};
+
+// --------------------------------------------------------------------------
+/// Output of ConfigYAML::parse straight into an app: the scalars are set through the decoder of the app,
+/// the items it does not take are given to a callback in the order of the document
+class DecodeOutput {
+public:
+    /// The options of the app are only set from the calling thread
+    static constexpr bool splittable = false;
+
+    DecodeOutput(const ConfigDecoder& decoder, const std::function<void(const ConfigItem&)>& item) :
+            decoder_(decoder), item_callback_(item)
+    {
+    }
+
+    void
+    enter(const std::string& name)
+    {
+        lengths_.push_back(key_.size());
+        ConfigDecoder::append(key_, name);
+    }
+
+    void
+    leave()
+    {
+        key_.resize(lengths_.back());
+        lengths_.pop_back();
+    }
+
+    void
+    value(const std::vector<std::string>& parents, const std::string& name, const std::string& input,
+            const std::string& tag)
+    {
+        flush();
+        auto length = key_.size();
+        ConfigDecoder::append(key_, name);
+        auto value = scalar_value(tag, input);
+        bool assigned = decoder_.assign(key_, value, input);
+        key_.resize(length);
+        if (!assigned) {
+            item_.parents = parents;
+            item_.name = name;
+            item_.inputs.assign(1, input);
+            item_.value = value;
+            item_callback_(item_);
+        }
+    }
+
+    void
+    sequence(const std::vector<std::string>& parents, const std::vector<const std::string*>& inputs)
+    {
+        flush();
+        item_.parents.clear();
+        item_.name.clear();
+        if (!parents.empty()) {
+            item_.name = parents.back();
+            item_.parents.assign(parents.begin(), std::prev(parents.end()));
+        }
+        item_.inputs.clear();
+        for (const auto* input: inputs) {
+            item_.inputs.push_back(*input);
+        }
+        item_.value = ConfigValue{};
+        item_callback_(item_);
+    }
+
+    /// The opening of a section is only given once the section is known not to be empty
+    void
+    open(const std::vector<std::string>& parents) { pending_.push_back(parents); }
+
+    void
+    close(const std::vector<std::string>& parents)
+    {
+        if (!pending_.empty()) {
+            pending_.pop_back();
+        }
+        else {
+            marker(parents, "--");
+        }
+    }
+
+    /// The maps are converted again for each of their aliases
+    bool
+    repeat(const YAML::Node&) { return false; }
+
+    std::size_t
+    position() const { return 0; }
+
+    void
+    record(const YAML::Node&, std::size_t) {}
+
+    /// The items built by the streaming handler are all given to the app, which parses them
+    void
+    add_items(std::vector<ConfigItem>&& items)
+    {
+        flush();
+        for (const auto& item: items) {
+            item_callback_(item);
+        }
+    }
+
+private:
+    void
+    flush()
+    {
+        for (const auto& parents: pending_) {
+            marker(parents, "++");
+        }
+        pending_.clear();
+    }
+
+    void
+    marker(const std::vector<std::string>& parents, const char* name)
+    {
+        item_.parents = parents;
+        item_.name = name;
+        item_.inputs.clear();
+        item_.value = ConfigValue{};
+        item_callback_(item_);
+    }
+
+    const ConfigDecoder& decoder_;
+    const std::function<void(const ConfigItem&)>& item_callback_;
+    /// the key of the current section, and the lengths of the keys of the sections holding it
+    std::string key_;
+    std::vector<std::size_t> lengths_;
+    std::vector<std::vector<std::string>> pending_;
+    /// reused for all the items given to the callback
+    ConfigItem item_;
+};
+
+// --------------------------------------------------------------------------
+/// Scanner of the subset of YAML used by most config files: block maps, block sequences of scalars, plain and
+/// quoted scalars on a single line and comments. It gives up on anything else (anchors, tags, flow collections,
+/// block scalars, escapes, several documents...) and the document is then loaded by yaml-cpp
+class BlockScanner {
+public:
+    /// Check and index a document, false when it is not in the subset, nothing is kept from the text
+    /// The limits are checked while the document is indexed, a ConfigError is thrown at the first one exceeded
+    bool
+    scan(std::string_view text, const Limits& limits)
+    {
+        entries_.clear();
+        lines_.clear();
+        pos_ = 0;
+        limits_ = &limits;
+        if (!split(text)) {
+            return false;
+        }
+        if (lines_.empty()) {
+            return true;
+        }
+        // a single map at the root, a sequence or a scalar document is left to yaml-cpp
+        if (!map(lines_.front().indent)) {
+            return false;
+        }
+        return pos_ == lines_.size();
+    }
+
+    /// Give the items of the scanned document to output, in the order of ConfigYAML::parse
+    template <typename Output>
+    void
+    emit(Output& output, const std::function<bool(const std::string&)>* load_section) const
+    {
+        if (entries_.empty()) {
+            return;
+        }
+        std::vector<std::string> parents;
+        emit_map(parents, output, load_section);
+    }
+
+private:
+    struct Line {
+        std::size_t indent;
+        std::string_view content;
+        /// the line in the document, from 1
+        std::size_t number;
+    };
+
+    struct Entry {
+        enum class Kind : std::uint8_t { Map, Sequence, Scalar, Null };
+        Kind kind;
+        /// a quoted scalar is always a string
+        bool quoted{false};
+        /// a single quoted scalar holding doubled quotes
+        bool escaped{false};
+        std::string_view key{};
+        std::string_view text{};
+        /// the index after the last entry of a map or a sequence
+        std::size_t end{0};
+    };
+
+    static const std::string&
+    tag(const Entry& entry)
+    {
+        static const std::string plain{"?"};
+        static const std::string quoted{"!"};
+        return entry.quoted ? quoted : plain;
+    }
+
+    static std::string
+    input(const Entry& entry)
+    {
+        if (!entry.escaped) {
+            return std::string(entry.text);
+        }
+        std::string text;
+        for (std::size_t i = 0; i < entry.text.size(); ++i) {
+            text.push_back(entry.text[i]);
+            if (entry.text[i] == '\'') {
+                ++i;
+            }
+        }
+        return text;
+    }
+
+    /// Split the text into its indented lines, the blank lines and the comments are dropped
+    bool
+    split(std::string_view text)
+    {
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        bool first = true;
+        std::size_t number = 0;
+        while (begin != end) {
+            ++number;
+            const char* eol = static_cast<const char*>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin)));
+            if (eol == nullptr) {
+                eol = end;
+            }
+            std::string_view line{begin, static_cast<std::size_t>(eol - begin)};
+            begin = eol == end ? end : eol + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (!plain_bytes(line)) {
+                return false;
+            }
+            auto indent = line.find_first_not_of(' ');
+            if (indent == std::string_view::npos || line[indent] == '#') {
+                continue;
+            }
+            auto content = line.substr(indent);
+            if (indent == 0 && (marker(content, "---") || marker(content, "..."))) {
+                // only the start of the single document is supported
+                if (!first || content[0] == '.' || !comment(content.substr(3))) {
+                    return false;
+                }
+                first = false;
+                continue;
+            }
+            first = false;
+            lines_.push_back({indent, content, number});
+        }
+        return true;
+    }
+
+    /// Reject the tabs, the control characters, the byte order marks and the unicode line breaks
+    static bool
+    plain_bytes(std::string_view line)
+    {
+        for (std::size_t i = 0; i < line.size(); ++i) {
+            auto c = static_cast<unsigned char>(line[i]);
+            if (c < 0x20 || c == 0x7f) {
+                return false;
+            }
+            if (c == 0xc2 && i + 1 < line.size() && static_cast<unsigned char>(line[i + 1]) == 0x85) {
+                return false;
+            }
+            if ((c == 0xe2 || c == 0xef) && i + 2 < line.size()) {
+                auto c1 = static_cast<unsigned char>(line[i + 1]);
+                auto c2 = static_cast<unsigned char>(line[i + 2]);
+                if ((c == 0xe2 && c1 == 0x80 && (c2 == 0xa8 || c2 == 0xa9)) || (c == 0xef && c1 == 0xbb && c2 == 0xbf)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// Check if a content starts with an indicator followed by a space or the end of the line
+    static bool
+    marker(std::string_view content, std::string_view indicator)
+    {
+        return content.substr(0, indicator.size()) == indicator
+               && (content.size() == indicator.size() || content[indicator.size()] == ' ');
+    }
+
+    /// Check if the rest of a line is empty or a comment
+    static bool
+    comment(std::string_view rest)
+    {
+        auto first = rest.find_first_not_of(' ');
+        return first == std::string_view::npos || (rest[first] == '#' && first > 0);
+    }
+
+    static std::string_view
+    trim(std::string_view text)
+    {
+        auto first = text.find_first_not_of(' ');
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        auto last = text.find_last_not_of(' ');
+        return text.substr(first, last - first + 1);
+    }
+
+    /// The block map of the lines at indent, with the maps nested in it
+    bool
+    map(std::size_t indent)
+    {
+        // the maps being read, from an explicit stack rather than a recursion per level
+        struct Open {
+            std::size_t index;
+            std::size_t indent;
+        };
+        std::vector<Open> open{{entries_.size(), indent}};
+        add({Entry::Kind::Map});
+        limits_->depth(open.size(), current_line());
+        while (!open.empty()) {
+            if (pos_ == lines_.size() || lines_[pos_].indent < open.back().indent) {
+                entries_[open.back().index].end = entries_.size();
+                open.pop_back();
+                continue;
+            }
+            const Line& line = lines_[pos_];
+            indent = open.back().indent;
+            if (line.indent != indent || marker(line.content, "-")) {
+                return false;
+            }
+            std::string_view key;
+            std::string_view rest;
+            if (!split_key(line.content, key, rest)) {
+                return false;
+            }
+            ++pos_;
+            limits_->scalar(key.size(), line.number);
+            if (!comment(rest)) {
+                if (!scalar(rest.substr(1), key)) {
+                    return false;
+                }
+                continue;
+            }
+            // the value is on the next lines: a nested map, a sequence, or nothing
+            if (pos_ < lines_.size() && lines_[pos_].indent >= indent && marker(lines_[pos_].content, "-")) {
+                limits_->depth(open.size() + 1, line.number);
+                if (!sequence(key, lines_[pos_].indent, indent)) {
+                    return false;
+                }
+            }
+            else if (pos_ < lines_.size() && lines_[pos_].indent > indent) {
+                open.push_back({entries_.size(), lines_[pos_].indent});
+                add({Entry::Kind::Map, false, false, key});
+                limits_->depth(open.size(), line.number);
+            }
+            else {
+                add({Entry::Kind::Null, false, false, key, {}, entries_.size() + 1});
+            }
+        }
+        return true;
+    }
+
+    /// Add an entry, counted as a value of the document
+    void
+    add(const Entry& entry)
+    {
+        entries_.push_back(entry);
+        limits_->items(entries_.size(), current_line());
+    }
+
+    /// The number of the line being read
+    std::size_t
+    current_line() const
+    {
+        return lines_[pos_ == 0 ? 0 : pos_ - 1].number;
+    }
+
+    /// The block sequence of scalars at indent, given to the key of a map at parent indent
+    bool
+    sequence(std::string_view key, std::size_t indent, std::size_t parent)
+    {
+        std::size_t index = entries_.size();
+        add({Entry::Kind::Sequence, false, false, key});
+        std::size_t length = 0;
+        while (pos_ < lines_.size() && lines_[pos_].indent >= indent) {
+            const Line& line = lines_[pos_];
+            if (line.indent != indent) {
+                return false;
+            }
+            if (!marker(line.content, "-")) {
+                // a key of the parent map is only allowed when the sequence is not indented
+                if (indent != parent) {
+                    return false;
+                }
+                break;
+            }
+            ++pos_;
+            limits_->sequence(++length, line.number);
+            auto rest = line.content.substr(1);
+            if (comment(rest)) {
+                add({Entry::Kind::Null, false, false, {}, {}, entries_.size() + 1});
+            }
+            else if (!scalar(rest.substr(1), {})) {
+                return false;
+            }
+        }
+        entries_[index].end = entries_.size();
+        return true;
+    }
+
+    /// Split a key line on the first colon followed by a space or the end of the line
+    static bool
+    split_key(std::string_view content, std::string_view& key, std::string_view& rest)
+    {
+        std::size_t colon = 0;
+        while (true) {
+            const void* found = std::memchr(content.data() + colon, ':', content.size() - colon);
+            if (found == nullptr) {
+                return false;
+            }
+            colon = static_cast<std::size_t>(static_cast<const char*>(found) - content.data());
+            if (colon + 1 == content.size() || content[colon + 1] == ' ') {
+                break;
+            }
+            ++colon;
+        }
+        key = trim(content.substr(0, colon));
+        rest = content.substr(colon + 1);
+        // only the plain keys that yaml-cpp reads as strings
+        if (key.empty() || key.size() > 1024 || std::strchr("-?:,[]{}#&*!|>'\"%@`<", key.front()) != nullptr
+                || key.find_first_of("#,[]{}") != std::string_view::npos || null_text(key)) {
+            return false;
+        }
+        return true;
+    }
+
+    static bool
+    null_text(std::string_view text)
+    {
+        return text == "~" || text == "null" || text == "Null" || text == "NULL";
+    }
+
+    /// A scalar on the rest of a line, after the indicator
+    bool
+    scalar(std::string_view rest, std::string_view key)
+    {
+        rest = rest.substr(std::min(rest.find_first_not_of(' '), rest.size()));
+        Entry entry{Entry::Kind::Scalar, false, false, key, {}, entries_.size() + 1};
+        if (rest.front() == '\'' || rest.front() == '"') {
+            char quote = rest.front();
+            std::size_t close = 1;
+            while (true) {
+                close = rest.find(quote, close);
+                if (close == std::string_view::npos) {
+                    // a multi line scalar
+                    return false;
+                }
+                if (quote == '\'' && close + 1 < rest.size() && rest[close + 1] == '\'') {
+                    entry.escaped = true;
+                    close += 2;
+                    continue;
+                }
+                break;
+            }
+            entry.text = rest.substr(1, close - 1);
+            if ((quote == '"' && entry.text.find('\\') != std::string_view::npos) || !comment(rest.substr(close + 1))) {
+                return false;
+            }
+            entry.quoted = true;
+        }
+        else {
+            if (std::strchr("[]{},#&*!|>%@`'\"", rest.front()) != nullptr
+                    || ((rest.front() == '-' || rest.front() == '?' || rest.front() == ':')
+                            && (rest.size() == 1 || rest[1] == ' '))) {
+                return false;
+            }
+            auto hash = rest.find(" #");
+            entry.text = trim(rest.substr(0, hash));
+            // a nested key on the same line
+            if (entry.text.back() == ':' || entry.text.find(": ") != std::string_view::npos) {
+                return false;
+            }
+            if (null_text(entry.text)) {
+                entry.kind = Entry::Kind::Null;
+            }
+        }
+        limits_->scalar(entry.text.size(), current_line());
+        add(entry);
+        return true;
+    }
+
+    /// Give the items of the root map and the maps nested in it, from an explicit stack
+    template <typename Output>
+    void
+    emit_map(std::vector<std::string>& parents, Output& output,
+            const std::function<bool(const std::string&)>* load_section) const
+    {
+        // the map being given and its next entry
+        struct Open {
+            std::size_t index;
+            std::size_t child;
+        };
+        std::vector<Open> open{{0, 1}};
+        while (!open.empty()) {
+            Open& current = open.back();
+            if (current.child == entries_[current.index].end) {
+                open.pop_back();
+                if (!open.empty()) {
+                    output.close(parents);
+                    output.leave();
+                    parents.pop_back();
+                }
+                continue;
+            }
+            std::size_t index = current.child;
+            const Entry& entry = entries_[index];
+            current.child = entry.end;
+            if (entry.kind == Entry::Kind::Scalar) {
+                output.value(parents, std::string(entry.key), input(entry), tag(entry));
+                continue;
+            }
+            parents.emplace_back(entry.key);
+            bool section = entry.kind == Entry::Kind::Map;
+            if (load_section != nullptr && section && open.size() == 1 && !(*load_section)(parents.front())) {
+                parents.pop_back();
+                continue;
+            }
+
+            output.enter(parents.back());
+            if (section) {
+                output.open(parents);
+                open.push_back({index, index + 1});
+                continue;
+            }
+            if (entry.kind == Entry::Kind::Sequence) {
+                std::vector<std::string> inputs;
+                for (std::size_t item = index + 1; item < entry.end; ++item) {
+                    if (entries_[item].kind == Entry::Kind::Scalar) {
+                        inputs.push_back(input(entries_[item]));
+                    }
+                }
+                std::vector<const std::string*> pointers;
+                pointers.reserve(inputs.size());
+                for (const auto& text: inputs) {
+                    pointers.push_back(&text);
+                }
+                output.sequence(parents, pointers);
+            }
+            output.leave();
+            parents.pop_back();
+        }
+    }
+
+    std::vector<Line> lines_;
+    std::vector<Entry> entries_;
+    /// the next line to scan
+    std::size_t pos_{0};
+    const Limits* limits_{nullptr};
+};
+
+// --------------------------------------------------------------------------
+/// Pre-scan of a document for ConfigYAML::parallel: the lines starting at column 0 outside of a quoted or flow
+/// scalar are the top level keys, a document is only split when each of the blocks they start stands alone
+class TopLevelSplitter {
+public:
+    /// Find the top level keys, false when the blocks may depend on each other or the top level is not a map
+    bool
+    scan(std::string_view text)
+    {
+        text_ = text;
+        starts_.assign(1, 0);
+        anchors_.clear();
+        quote_ = 0;
+        flow_ = 0;
+        literal_ = npos;
+        keys_ = false;
+
+        std::size_t begin = 0;
+        while (begin < text.size()) {
+            auto eol = text.find('\n', begin);
+            if (eol == std::string_view::npos) {
+                eol = text.size();
+            }
+            if (!line(begin, text.substr(begin, eol - begin))) {
+                return false;
+            }
+            begin = eol + 1;
+        }
+        return quote_ == 0 && flow_ == 0;
+    }
+
+    /// The text of at most `count` parts holding whole blocks, of at least `minimum` bytes except the last one
+    std::vector<std::string_view>
+    parts(std::size_t count, std::size_t minimum) const
+    {
+        std::size_t size = std::max({minimum, text_.size() / std::max<std::size_t>(count, 1), std::size_t{1}});
+        std::vector<std::string_view> parts;
+        std::size_t begin = 0;
+        for (std::size_t start: starts_) {
+            if (start - begin >= size) {
+                parts.push_back(text_.substr(begin, start - begin));
+                begin = start;
+            }
+        }
+        if (parts.empty() || text_.size() - begin >= size) {
+            parts.push_back(text_.substr(begin));
+        }
+        else {
+            // the tail is too small on its own
+            parts.back() = text_.substr(parts.back().data() - text_.data());
+        }
+        return parts;
+    }
+
+private:
+    static constexpr std::size_t npos = std::string_view::npos;
+
+    bool
+    line(std::size_t offset, std::string_view text)
+    {
+        if (!text.empty() && text.back() == '\r') {
+            text.remove_suffix(1);
+        }
+        auto indent = text.find_first_not_of(' ');
+        if (indent == npos || text[indent] == '#') {
+            return true;
+        }
+        if (literal_ != npos) {
+            // the content of a block scalar is not read, up to a line not indented more than its key
+            if (indent > literal_) {
+                return true;
+            }
+            literal_ = npos;
+        }
+        if (indent == 0 && quote_ == 0 && flow_ == 0) {
+            if (!keys_ && text.compare(0, 3, "---") == 0
+                    && (text.size() == 3 || text[3] == ' ') && ends(text.substr(3))) {
+                // the start of the only document
+                return true;
+            }
+            // the other directives and document markers, and the keys that are not plain or quoted scalars
+            if (std::strchr("%-?:[]{},&*!|>@`\t", text[0]) != nullptr || text.compare(0, 3, "...") == 0) {
+                return false;
+            }
+            if (keys_) {
+                starts_.push_back(offset);
+            }
+            keys_ = true;
+        }
+        else if (!keys_) {
+            // the top level map must start at column 0
+            return false;
+        }
+        return tokens(text, indent);
+    }
+
+    /// Check that only spaces and a comment are left on a line
+    static bool
+    ends(std::string_view rest)
+    {
+        auto next = rest.find_first_not_of(' ');
+        return next == npos || rest[next] == '#';
+    }
+
+    /// Follow the quotes, the flow collections, the block scalars and the anchors and aliases of a line
+    bool
+    tokens(std::string_view text, std::size_t indent)
+    {
+        bool start = quote_ == 0;
+        for (std::size_t i = indent; i < text.size(); ++i) {
+            char c = text[i];
+            if (quote_ == '"') {
+                if (c == '\\') {
+                    ++i;
+                }
+                else if (c == '"') {
+                    quote_ = 0;
+                }
+                continue;
+            }
+            if (quote_ == '\'') {
+                if (c == '\'' && i + 1 < text.size() && text[i + 1] == '\'') {
+                    ++i;
+                }
+                else if (c == '\'') {
+                    quote_ = 0;
+                }
+                continue;
+            }
+            if (c == ' ') {
+                continue;
+            }
+            if (c == '#' && (i == 0 || text[i - 1] == ' ')) {
+                break;
+            }
+            bool separated = i + 1 == text.size() || text[i + 1] == ' ';
+            if (flow_ > 0 && (c == ']' || c == '}')) {
+                --flow_;
+                start = false;
+            }
+            else if (flow_ > 0 && c == ',') {
+                start = true;
+            }
+            else if (c == ':' && (separated || flow_ > 0)) {
+                start = true;
+            }
+            else if (!start) {
+                continue;
+            }
+            else if (c == '"' || c == '\'') {
+                quote_ = c;
+                start = false;
+            }
+            else if (c == '[' || c == '{') {
+                ++flow_;
+            }
+            else if ((c == '|' || c == '>') && flow_ == 0) {
+                literal_ = indent;
+                return true;
+            }
+            else if (c == '&' || c == '*') {
+                auto end = text.find_first_of(" ,[]{}", i);
+                auto name = text.substr(i + 1, (end == npos ? text.size() : end) - i - 1);
+                if (c == '&') {
+                    anchors_[name] = starts_.size();
+                }
+                else {
+                    // an alias of an anchor defined in another block
+                    auto found = anchors_.find(name);
+                    if (found == anchors_.end() || found->second != starts_.size()) {
+                        return false;
+                    }
+                    start = false;
+                }
+                i += name.size();
+            }
+            else if (c == '!') {
+                i = std::min(text.find(' ', i), text.size());
+            }
+            else if ((c == '-' || c == '?') && separated) {
+            }
+            else {
+                start = false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view text_{};
+    /// A top level key was found
+    bool keys_{false};
+    /// The offsets of the blocks, the first one starts with the document
+    std::vector<std::size_t> starts_{};
+    /// The block of the last definition of an anchor
+    std::unordered_map<std::string_view, std::size_t> anchors_{};
+    char quote_{0};
+    std::size_t flow_{0};
+    /// The indentation of the key of a block scalar while its content is skipped
+    std::size_t literal_{npos};
+};
+
+// --------------------------------------------------------------------------
+/// Parser of a JSON document held in a contiguous buffer, giving its items to an output of ConfigYAML::parse in
+/// the same order. The tokens are views of the buffer, only the strings holding escapes are decoded
+template <typename Output>
+class JSONParser {
+public:
+    JSONParser(std::string_view text, Output& output) : text_(text), output_(output) {}
+
+    void
+    parse()
+    {
+        std::vector<std::string> parents;
+        space();
+        if (pos_ == text_.size()) {
+            return;
+        }
+        if (peek() == '{' || peek() == '[') {
+            values(parents);
+        }
+        else {
+            scalar();
+        }
+        space();
+        if (pos_ != text_.size()) {
+            error("unexpected content after the document");
+        }
+    }
+
+private:
+    enum class Token { String, Literal, Null };
+
+    [[noreturn]] void
+    error(const std::string& message) const
+    {
+        auto line = std::count(text_.begin(), text_.begin() + static_cast<std::ptrdiff_t>(pos_), '\n') + 1;
+        auto start = text_.rfind('\n', pos_ == 0 ? 0 : pos_ - 1);
+        auto column = pos_ - (start == std::string_view::npos ? 0 : start + 1) + 1;
+        throw ConfigError("JSON: " + message + " at line " + std::to_string(line) + ", column "
+                + std::to_string(column));
+    }
+
+    char
+    peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+    void
+    space()
+    {
+        while (pos_ < text_.size()
+                && (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t')) {
+            ++pos_;
+        }
+    }
+
+    void
+    expect(char c)
+    {
+        if (peek() != c) {
+            error(std::string("expected '") + c + "'");
+        }
+        ++pos_;
+    }
+
+    /// A map or a sequence being read, the values they nest are read in a loop with a stack of levels, so the depth
+    /// of a document is only bounded by the memory
+    struct Level {
+        bool array{false};
+        /// The value of a key, named after the last parent
+        bool member{false};
+        /// The scalars of an array
+        std::vector<std::string> inputs{};
+    };
+
+    /// Read the map or the sequence starting at the current character and the values it nests
+    void
+    values(std::vector<std::string>& parents)
+    {
+        std::vector<Level> levels;
+        if (!open(levels, false)) {
+            close(levels, parents);
+            return;
+        }
+        bool read = true;
+        while (!levels.empty()) {
+            if (read) {
+                Level& level = levels.back();
+                if (!level.array) {
+                    if (peek() != '"') {
+                        error("expected a string key");
+                    }
+                    std::string name{string()};
+                    space();
+                    expect(':');
+                    space();
+                    if (peek() == '{' || peek() == '[') {
+                        parents.push_back(std::move(name));
+                        output_.enter(parents.back());
+                        if (peek() == '{') {
+                            output_.open(parents);
+                        }
+                        if (open(levels, true)) {
+                            continue;
+                        }
+                        close(levels, parents);
+                    }
+                    else {
+                        auto token = scalar();
+                        if (token == Token::Null) {
+                            // a null value is an empty section, as the YAML ones
+                            parents.push_back(std::move(name));
+                            output_.enter(parents.back());
+                            output_.leave();
+                            parents.pop_back();
+                        }
+                        else {
+                            output_.value(parents, std::move(name), value_, tag(token));
+                        }
+                    }
+                }
+                else if (peek() == '{' || peek() == '[') {
+                    // the objects of an array are read in the section of the array
+                    if (open(levels, false)) {
+                        continue;
+                    }
+                    close(levels, parents);
+                }
+                else if (scalar() != Token::Null) {
+                    level.inputs.push_back(value_);
+                }
+            }
+            // after a value of the innermost level
+            space();
+            if (peek() == ',') {
+                ++pos_;
+                space();
+                read = true;
+                continue;
+            }
+            expect(levels.back().array ? ']' : '}');
+            close(levels, parents);
+            read = false;
+        }
+    }
+
+    /// Start a level at its opening bracket, false when it is empty and already ended
+    bool
+    open(std::vector<Level>& levels, bool member)
+    {
+        bool array = peek() == '[';
+        ++pos_;
+        levels.push_back(Level{array, member, {}});
+        space();
+        if (peek() == (array ? ']' : '}')) {
+            ++pos_;
+            return false;
+        }
+        return true;
+    }
+
+    /// End the innermost level, the scalars of an array are the inputs of an item named after the last parent
+    void
+    close(std::vector<Level>& levels, std::vector<std::string>& parents)
+    {
+        Level& level = levels.back();
+        if (level.array) {
+            std::vector<const std::string*> pointers;
+            pointers.reserve(level.inputs.size());
+            for (const auto& input: level.inputs) {
+                pointers.push_back(&input);
+            }
+            output_.sequence(parents, pointers);
+        }
+        if (level.member) {
+            if (!level.array) {
+                output_.close(parents);
+            }
+            output_.leave();
+            parents.pop_back();
+        }
+        levels.pop_back();
+    }
+
+    static const std::string&
+    tag(Token token)
+    {
+        static const std::string plain{"?"};
+        static const std::string quoted{"!"};
+        return token == Token::String ? quoted : plain;
+    }
+
+    /// Read a scalar into value_
+    Token
+    scalar()
+    {
+        char c = peek();
+        if (c == '"') {
+            value_.assign(string());
+            return Token::String;
+        }
+        auto start = pos_;
+        for (const char* word: {"true", "false", "null"}) {
+            if (text_.compare(pos_, std::strlen(word), word) == 0) {
+                pos_ += std::strlen(word);
+                value_.assign(text_.substr(start, pos_ - start));
+                return word[0] == 'n' ? Token::Null : Token::Literal;
+            }
+        }
+        if (peek() == '-') {
+            ++pos_;
+        }
+        if (peek() == '0') {
+            ++pos_;
+        }
+        else if (!digits()) {
+            error("invalid value");
+        }
+        if (peek() == '.') {
+            ++pos_;
+            if (!digits()) {
+                error("invalid number");
+            }
+        }
+        if (peek() == 'e' || peek() == 'E') {
+            ++pos_;
+            if (peek() == '+' || peek() == '-') {
+                ++pos_;
+            }
+            if (!digits()) {
+                error("invalid number");
+            }
+        }
+        value_.assign(text_.substr(start, pos_ - start));
+        return Token::Literal;
+    }
+
+    bool
+    digits()
+    {
+        auto start = pos_;
+        while (peek() >= '0' && peek() <= '9') {
+            ++pos_;
+        }
+        return pos_ != start;
+    }
+
+    /// Read a string, a view of the buffer unless it holds escapes
+    std::string_view
+    string()
+    {
+        auto start = ++pos_;
+        const char* found = static_cast<const char*>(std::memchr(text_.data() + pos_, '"', text_.size() - pos_));
+        if (found == nullptr) {
+            pos_ = text_.size();
+            error("unterminated string");
+        }
+        auto close = static_cast<std::size_t>(found - text_.data());
+        auto raw = text_.substr(start, close - start);
+        // the quote found may be escaped
+        if (raw.find('\\') != std::string_view::npos) {
+            return unescape(start);
+        }
+        for (char c: raw) {
+            if (static_cast<unsigned char>(c) < 0x20) {
+                error("control character in a string");
+            }
+        }
+        pos_ = close + 1;
+        return raw;
+    }
+
+    /// Decode a string holding escapes into escaped_, from its first character
+    std::string_view
+    unescape(std::size_t start)
+    {
+        escaped_.clear();
+        pos_ = start;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                error("unterminated string");
+            }
+            char c = text_[pos_++];
+            if (c == '"') {
+                return escaped_;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                --pos_;
+                error("control character in a string");
+            }
+            if (c != '\\') {
+                escaped_.push_back(c);
+                continue;
+            }
+            switch (pos_ < text_.size() ? text_[pos_++] : '\0') {
+                case '"':
+                    escaped_.push_back('"');
+                    break;
+                case '\\':
+                    escaped_.push_back('\\');
+                    break;
+                case '/':
+                    escaped_.push_back('/');
+                    break;
+                case 'b':
+                    escaped_.push_back('\b');
+                    break;
+                case 'f':
+                    escaped_.push_back('\f');
+                    break;
+                case 'n':
+                    escaped_.push_back('\n');
+                    break;
+                case 'r':
+                    escaped_.push_back('\r');
+                    break;
+                case 't':
+                    escaped_.push_back('\t');
+                    break;
+                case 'u':
+                    code_point();
+                    break;
+                default:
+                    error("invalid escape");
+            }
+        }
+    }
+
+    unsigned
+    hex4()
+    {
+        unsigned value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = peek();
+            unsigned digit = 0;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<unsigned>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f') {
+                digit = static_cast<unsigned>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F') {
+                digit = static_cast<unsigned>(c - 'A' + 10);
+            }
+            else {
+                error("invalid unicode escape");
+            }
+            value = value * 16 + digit;
+            ++pos_;
+        }
+        return value;
+    }
+
+    /// Append the UTF-8 encoding of a \u escape, a surrogate pair is read as one code point
+    void
+    code_point()
+    {
+        unsigned code = hex4();
+        if (code >= 0xd800 && code < 0xdc00 && text_.compare(pos_, 2, "\\u") == 0) {
+            pos_ += 2;
+            unsigned low = hex4();
+            if (low < 0xdc00 || low >= 0xe000) {
+                error("invalid surrogate pair");
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        }
+        if (code < 0x80) {
+            escaped_.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800) {
+            escaped_.push_back(static_cast<char>(0xc0 | (code >> 6)));
+            escaped_.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        }
+        else if (code < 0x10000) {
+            escaped_.push_back(static_cast<char>(0xe0 | (code >> 12)));
+            escaped_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+            escaped_.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        }
+        else {
+            escaped_.push_back(static_cast<char>(0xf0 | (code >> 18)));
+            escaped_.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+            escaped_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+            escaped_.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        }
+    }
+
+    std::string_view text_;
+    Output& output_;
+    std::size_t pos_{0};
+    /// the text of the last scalar, reused for all of them
+    std::string value_;
+    /// the last string decoded from its escapes
+    std::string escaped_;
+};
+
+#ifdef CLI11_YAML_SCANNER_CHECK
+/// Check if two lists of items are the same, typed values included
+bool
+same_items(const std::vector<ConfigItem>& lhs, const std::vector<ConfigItem>& rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const ConfigItem& l, const ConfigItem& r) {
+        return l.parents == r.parents && l.name == r.name && l.inputs == r.inputs && l.value.type == r.value.type
+               && l.value.integer == r.value.integer && l.value.boolean == r.value.boolean
+               && (l.value.real == r.value.real || (l.value.real != l.value.real && r.value.real != r.value.real));
+    });
+}
+#endif
+
+}
+
+// --------------------------------------------------------------------------
+/// Paths defined by the documents of a stream, the last document being converted first
+/// A value of a previous document is shadowed by any value or section at its path, or above it
+/// The paths of the current document never shadow each other, the items of a sequence share its path
+struct ConfigYAML::Layers {
+    enum class Layer { New, Merged, Shadowed };
+
+    /// Register a value, New when no later document defined the path
+    Layer
+    value(const std::string& path)
+    {
+        auto inserted = paths_.emplace(path, Entry{false, document_});
+        if (inserted.second) {
+            return Layer::New;
+        }
+        if (inserted.first->second.document == document_) {
+            inserted.first->second.section = false;
+            return Layer::New;
+        }
+        return Layer::Shadowed;
+    }
+
+    /// Register a section, Merged when a later document already has it
+    Layer
+    section(const std::string& path)
+    {
+        auto inserted = paths_.emplace(path, Entry{true, document_});
+        if (inserted.second || inserted.first->second.document == document_) {
+            return Layer::New;
+        }
+        return inserted.first->second.section ? Layer::Merged : Layer::Shadowed;
+    }
+
+    /// Check if a section was registered by the current document
+    bool
+    opened(const std::string& path) const
+    {
+        auto found = paths_.find(path);
+        return found != paths_.end() && found->second.section && found->second.document == document_;
+    }
+
+    void
+    next_document() { ++document_; }
+
+    static void
+    append(std::string& path, const std::string& name)
+    {
+        path.push_back('\0');
+        path.append(name);
+    }
+
+    static std::string
+    path(const std::vector<std::string>& parents)
+    {
+        std::string result;
+        for (const auto& parent: parents) {
+            append(result, parent);
+        }
+        return result;
+    }
+
+    static std::string
+    path(const std::vector<std::string>& parents, const std::string& name)
+    {
+        std::string result = path(parents);
+        append(result, name);
+        return result;
+    }
+
+private:
+    struct Entry {
+        bool section;
+        std::size_t document;
+    };
+
+    std::unordered_map<std::string, Entry> paths_;
+    std::size_t document_{0};
+};
+
 std::string
-ConfigYAML::to_config(const App*, bool, bool, std::string) const
+ConfigYAML::to_config(const App* app, bool default_also, bool write_description, std::string prefix) const
+{
+    std::stringstream out;
+    ConfigWriter<YAMLEmitter> writer{out, default_also, write_description};
+    writer.write(app, prefix.empty() ? std::vector<std::string>{} : detail::split(prefix, '.'));
+    return out.str();
+}
+
+std::vector<ConfigItem>
+ConfigYAML::from_file(const std::string& name) const
 {
-    return {};
+    return from_file(name, {});
+}
+
+std::vector<ConfigItem>
+ConfigYAML::from_file(const std::string& name, const std::function<bool(const std::string&)>& load_section) const
+{
+    const auto* filter = (lazyMode && load_section) ? &load_section : nullptr;
+    // the items of a cache entry cannot be checked against the limits, a limited document is always parsed
+    bool limited = maximumDepth != 0 || maximumItems != 0 || maximumSequence != 0 || maximumScalar != 0;
+    if (cacheDirectory.empty() || limited) {
+        if (filter == nullptr) {
+            return Config::from_file(name);
+        }
+        detail::MappedFile file;
+        if (file.open(name)) {
+            std::string_view text{file.data(), file.size()};
+            detail::BufferStreambuf buffer{text.data(), text.size()};
+            std::istream input{&buffer};
+            return load(input, &text, filter);
+        }
+        std::ifstream input{name};
+        if (!input.good()) {
+            throw FileError::Missing(name);
+        }
+        return load(input, nullptr, filter);
+    }
+
+    // only regular files are cached, they are mapped to compute the content hash
+    detail::MappedFile file;
+    std::error_code ec;
+    auto path = std::filesystem::absolute(name, ec);
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec || !file.open(name)) {
+        return Config::from_file(name);
+    }
+
+    item_cache::Identity identity;
+    identity.path = path.string();
+    identity.settings = configSection + '\0' + std::to_string(configIndex);
+    for (std::size_t limit: {maximumDepth, maximumItems, maximumSequence, maximumScalar}) {
+        identity.settings += '\0' + std::to_string(limit);
+    }
+    identity.size = file.size();
+    identity.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+    identity.hash = item_cache::hash(file.data(), file.size());
+
+    // the cache holds all the sections, the lazy mode then only drops the items of the unused ones
+    auto location = item_cache::location(cacheDirectory, identity.path);
+    std::vector<ConfigItem> output;
+    if (!item_cache::load(location, identity, output)) {
+        output = from_buffer(file.data(), file.size());
+        item_cache::store(location, identity, output);
+    }
+    if (filter != nullptr) {
+        output.erase(std::remove_if(output.begin(), output.end(), [filter](const ConfigItem& item) {
+            return !item.parents.empty() && !(*filter)(item.parents.front());
+        }), output.end());
+    }
+    return output;
 }
 
 std::vector<ConfigItem>
 ConfigYAML::from_config(std::istream& is) const
 {
-    YAML::Node config = YAML::Load(is);
-    return parse(config, {});
+    return load(is, nullptr, nullptr);
+}
+
+std::vector<ConfigItem>
+ConfigYAML::from_buffer(const char* data, std::size_t size) const
+{
+    // a derived class may change from_config, the buffer is then read through it
+    if (!supports_compact()) {
+        return Config::from_buffer(data, size);
+    }
+    std::string_view text{data, size};
+    detail::BufferStreambuf buffer{data, size};
+    std::istream input{&buffer};
+    return load(input, &text, nullptr);
+}
+
+bool
+ConfigYAML::decode_file(const std::string& name, const ConfigDecoder& decoder,
+        const std::function<void(const ConfigItem&)>& item,
+        const std::function<bool(const std::string&)>& load_section) const
+{
+    if (!supports_decode()) {
+        return false;
+    }
+
+    const auto* filter = (lazyMode && load_section) ? &load_section : nullptr;
+    DecodeOutput output{decoder, item};
+    detail::MappedFile file;
+    if (file.open(name)) {
+        std::string_view text{file.data(), file.size()};
+        detail::BufferStreambuf buffer{text.data(), text.size()};
+        std::istream input{&buffer};
+        convert(input, &text, output, filter);
+        return true;
+    }
+    std::ifstream input{name};
+    if (!input.good()) {
+        throw FileError::Missing(name);
+    }
+    convert(input, nullptr, output, filter);
+    return true;
+}
+
+bool
+ConfigYAML::supports_decode() const
+{
+    // the cache and the streaming handler hold ConfigItems
+    return decodeMode && cacheDirectory.empty() && !streamingMode;
+}
+
+CompactConfig
+ConfigYAML::from_config_compact(std::istream& is) const
+{
+    return load_compact(is, nullptr, nullptr);
+}
+
+CompactConfig
+ConfigYAML::from_file_compact(const std::string& name,
+        const std::function<bool(const std::string&)>& load_section) const
+{
+    // the cache and the streaming handler hold ConfigItems
+    if (!cacheDirectory.empty() || streamingMode) {
+        return CompactConfig(from_file(name, load_section));
+    }
+
+    const auto* filter = (lazyMode && load_section) ? &load_section : nullptr;
+    detail::MappedFile file;
+    if (file.open(name)) {
+        std::string_view text{file.data(), file.size()};
+        detail::BufferStreambuf buffer{text.data(), text.size()};
+        std::istream input{&buffer};
+        return load_compact(input, &text, filter);
+    }
+    std::ifstream input{name};
+    if (!input.good()) {
+        throw FileError::Missing(name);
+    }
+    return load_compact(input, nullptr, filter);
+}
+
+bool
+ConfigYAML::supports_compact() const
+{
+#if CLI11_USE_STATIC_RTTI == 0
+    return typeid(*this) == typeid(ConfigYAML);
+#else
+    return false;
+#endif
+}
+
+std::vector<ConfigItem>
+ConfigYAML::load(std::istream& is, const std::string_view* text,
+        const std::function<bool(const std::string&)>* load_section) const
+{
+    if (streamingMode) {
+        return stream(is, load_section);
+    }
+
+    std::vector<ConfigItem> output;
+    ItemOutput items{output};
+    convert(is, text, items, load_section);
+    return output;
 }
 
 std::vector<ConfigItem>
-ConfigYAML::parse(const YAML::Node& node, std::vector<std::string> parents) const
+ConfigYAML::stream(std::istream& is, const std::function<bool(const std::string&)>* load_section) const
 {
+    std::vector<std::string> section;
+    if (!configSection.empty()) {
+        section = detail::split(configSection, '.');
+    }
     std::vector<ConfigItem> output;
+    std::vector<std::size_t> documents;
+    ConfigYAMLHandler handler{output, std::move(section), configIndex, load_section};
+    // the limits are checked on the events before they reach the handler
+    Limits limits{maximumDepth, maximumItems, maximumSequence, maximumScalar};
+    LimitHandler limited{limits, &handler};
+    YAML::EventHandler& events = limits.active() ? static_cast<YAML::EventHandler&>(limited) : handler;
+    YAML::Parser parser{is};
+    do {
+        documents.push_back(output.size());
+    } while (parser.HandleNextDocument(events));
+    documents.pop_back();
+    if (documents.size() > 1) {
+        return overlay(std::move(output), documents);
+    }
+    return output;
+}
+
+CompactConfig
+ConfigYAML::load_compact(std::istream& is, const std::string_view* text,
+        const std::function<bool(const std::string&)>* load_section) const
+{
+    // the streaming handler builds ConfigItems, they are only converted at the end
+    if (streamingMode) {
+        return CompactConfig(load(is, text, load_section));
+    }
 
-    switch (node.Type()) {
-        case YAML::NodeType::Null: {
+    CompactConfig output;
+    CompactOutput items{output};
+    convert(is, text, items, load_section);
+    return output;
+}
 
-//            ConfigItem config_item;
-//            config_item.name = (parents.empty() ? "" : *parents.rbegin());
-//            config_item.parents = parents;
-//            if (!config_item.parents.empty())
-//                config_item.parents.erase(config_item.parents.rbegin().base());
-//            config_item.inputs.emplace_back("true");
-//            output.push_back(std::move(config_item));
+template <typename Output>
+void
+ConfigYAML::convert(std::istream& is, const std::string_view* text, Output& output,
+        const std::function<bool(const std::string&)>* load_section) const
+{
+    std::vector<std::string> section;
+    if (!configSection.empty()) {
+        section = detail::split(configSection, '.');
+    }
 
-            break;
+    // the scanner and the split need the whole text, a stream is read into a string for them and yaml-cpp then
+    // reads it from there, a mapped file is used in place
+    std::string read;
+    bool consumed = false;
+    if ((scannerMode || parallelThreads > 1) && section.empty()) {
+        if (text == nullptr) {
+            read = read_all(is);
+            consumed = true;
         }
-        case YAML::NodeType::Scalar: {
-            break;
+        std::string_view whole = text != nullptr ? *text : std::string_view{read};
+        if (parallelThreads > 1 && convert_parallel(whole, output, load_section)) {
+            return;
         }
-        case YAML::NodeType::Sequence: {
-            ConfigItem config_item;
-            config_item.name = parents.empty() ? "" : *parents.rbegin();
+        if (scannerMode && scan(whole, output, load_section)) {
+            return;
+        }
+    }
+    detail::BufferStreambuf buffer{read.data(), read.size()};
+    std::istream read_input{&buffer};
+    std::istream& input = consumed ? read_input : is;
+
+    // the limits are checked on the parser events, the streaming handler builds the items in the same pass
+    if (Limits{maximumDepth, maximumItems, maximumSequence, maximumScalar}.active()) {
+        output.add_items(stream(input, load_section));
+        return;
+    }
 
-            config_item.parents = parents;
-            if (!config_item.parents.empty())
-                config_item.parents.erase(config_item.parents.rbegin().base());
+    std::vector<YAML::Node> documents = YAML::LoadAll(input);
+    std::vector<std::string> parents;
+    if (documents.size() == 1 && section.empty()) {
+        parse(documents.front(), parents, output, nullptr, load_section);
+        return;
+    }
 
-            for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
-                if (it->IsScalar()) {
-                    config_item.inputs.push_back(it->as<std::string>());
-                }
-                else {
-                    for (auto ci: parse(*it, parents)) {
-                        output.push_back(std::move(ci));
+    // the last document is converted first, the keys it defines are then skipped in the previous ones
+    Layers layers;
+    for (auto it = documents.rbegin(); it != documents.rend(); ++it) {
+        for (const auto& node: select(*it, section)) {
+            parse(node, parents, output, documents.size() > 1 ? &layers : nullptr, load_section);
+        }
+        layers.next_document();
+    }
+}
+
+template <typename Output>
+bool
+ConfigYAML::scan(std::string_view text, Output& output, const std::function<bool(const std::string&)>* load_section) const
+{
+    BlockScanner scanner;
+    if (!scanner.scan(text, Limits{maximumDepth, maximumItems, maximumSequence, maximumScalar})) {
+        return false;
+    }
+#ifdef CLI11_YAML_SCANNER_CHECK
+    // differential build of the tests: the scanned items must be the ones of the yaml-cpp tree
+    std::vector<ConfigItem> scanned;
+    std::vector<ConfigItem> loaded;
+    ItemOutput scanned_output{scanned};
+    ItemOutput loaded_output{loaded};
+    scanner.emit(scanned_output, load_section);
+    std::vector<YAML::Node> check;
+    try {
+        check = YAML::LoadAll(std::string(text));
+    }
+    catch (const YAML::Exception& e) {
+        throw HorribleError("the YAML scanner accepted an invalid document: " + std::string(e.what()));
+    }
+    if (check.size() > 1) {
+        throw HorribleError("the YAML scanner accepted several documents");
+    }
+    std::vector<std::string> check_parents;
+    if (!check.empty()) {
+        parse(check.front(), check_parents, loaded_output, nullptr, load_section);
+    }
+    if (!same_items(scanned, loaded)) {
+        throw HorribleError("the YAML scanner items differ from the yaml-cpp ones");
+    }
+#endif
+    scanner.emit(output, load_section);
+    return true;
+}
+
+template <typename Output>
+bool
+ConfigYAML::convert_parallel(std::string_view text, Output& output,
+        const std::function<bool(const std::string&)>* load_section) const
+{
+    if constexpr (!Output::splittable) {
+        return false;
+    }
+    else {
+        // the values are counted over the whole document
+        Limits limits{maximumDepth, maximumItems, maximumSequence, maximumScalar};
+        TopLevelSplitter splitter;
+        if (limits.counts_items() || !splitter.scan(text)) {
+            return false;
+        }
+        auto parts = splitter.parts(parallelThreads, parallelMinimum);
+        if (parts.size() < 2) {
+            return false;
+        }
+
+        // a part that does not load as a single map, or that fails, sends the document back to the conversion
+        // in one piece, which raises the errors with their position in the whole document
+        std::vector<typename Output::Part> results(parts.size());
+        std::vector<char> converted(parts.size(), 0);
+        std::atomic<std::size_t> next{0};
+        auto convert_parts = [&]() {
+            for (std::size_t index = next++; index < parts.size(); index = next++) {
+                try {
+                    Output part{results[index]};
+                    if (scannerMode && scan(parts[index], part, load_section)) {
+                        converted[index] = 1;
+                        continue;
+                    }
+                    // the limits are checked by the streaming handler, on the events of the whole document
+                    if (limits.active()) {
+                        continue;
+                    }
+                    detail::BufferStreambuf buffer{parts[index].data(), parts[index].size()};
+                    std::istream input{&buffer};
+                    auto documents = YAML::LoadAll(input);
+                    if (documents.size() == 1 && documents.front().IsMap()) {
+                        std::vector<std::string> parents;
+                        parse(documents.front(), parents, part, nullptr, load_section);
+                        converted[index] = 1;
                     }
                 }
+                catch (const std::exception&) {
+                }
+            }
+        };
+
+        // the calling thread takes its share of the parts
+        std::size_t thread_count = std::min<std::size_t>(parts.size(), parallelThreads);
+        std::vector<std::thread> threads;
+        for (std::size_t ii = 1; ii < thread_count; ++ii) {
+            try {
+                threads.emplace_back(convert_parts);
+            }
+            catch (const std::system_error&) {
+                break;
             }
-            output.push_back(std::move(config_item));
-            break;
         }
-        case YAML::NodeType::Map: {
+        convert_parts();
+        for (auto& thread: threads) {
+            thread.join();
+        }
+
+        if (std::find(converted.begin(), converted.end(), 0) != converted.end()) {
+            return false;
+        }
+        for (auto& result: results) {
+            output.append(std::move(result));
+        }
+        return true;
+    }
+}
 
-            for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
-                if (it->second.IsScalar()) {
+std::vector<YAML::Node>
+ConfigYAML::select(const YAML::Node& document, const std::vector<std::string>& section) const
+{
+    YAML::Node node = document;
+    for (const auto& key: section) {
+        if (!node.IsMap()) {
+            return {};
+        }
+        YAML::Node child = static_cast<const YAML::Node&>(node)[key];
+        if (!child.IsDefined()) {
+            return {};
+        }
+        // reset rebinds the node, an assignment would overwrite the content of the document
+        node.reset(child);
+    }
+    if (section.empty() || node.IsMap()) {
+        return {node};
+    }
 
-                    ConfigItem config_item;
-                    config_item.name = it->first.as<std::string>();
-                    config_item.parents = parents;
-                    config_item.inputs.push_back(it->second.as<std::string>());
-                    output.push_back(std::move(config_item));
+    std::vector<YAML::Node> selected;
+    if (node.IsSequence()) {
+        int index = 0;
+        for (YAML::const_iterator it = node.begin(); it != node.end(); ++it, ++index) {
+            if (it->IsMap() && (configIndex < 0 || index == configIndex)) {
+                selected.push_back(*it);
+            }
+        }
+    }
+    return selected;
+}
 
+std::vector<ConfigItem>
+ConfigYAML::overlay(std::vector<ConfigItem> items, const std::vector<std::size_t>& documents) const
+{
+    std::vector<ConfigItem> output;
+    Layers layers;
+    for (std::size_t document = documents.size(); document-- > 0;) {
+        auto begin = items.begin() + static_cast<std::ptrdiff_t>(documents[document]);
+        auto end = document + 1 < documents.size() ? items.begin() + static_cast<std::ptrdiff_t>(documents[document + 1])
+                                                   : items.end();
+        std::set<std::string> opened;
+        // the maps of the document, the other parents of the items are sequences, which are values
+        std::set<std::string> maps;
+        for (auto item = begin; item != end; ++item) {
+            if (item->name == "++") {
+                maps.insert(Layers::path(item->parents));
+            }
+            // the sections holding the item must not be values of a later document
+            std::string path;
+            bool shadowed = false;
+            for (const auto& parent: item->parents) {
+                Layers::append(path, parent);
+                auto layer = maps.count(path) != 0 ? layers.section(path) : layers.value(path);
+                if (layer == Layers::Layer::Shadowed) {
+                    shadowed = true;
+                    break;
                 }
-                else {
-                    auto tmp = parents;
-                    tmp.push_back(it->first.as<std::string>());
-
-                    if (it->second.IsMap()) { // Only Map start a section (not a sequence)
-                        ConfigItem config_item_open;
-                        config_item_open.name = "++";
-                        config_item_open.parents = tmp;
-                        output.push_back(std::move(config_item_open));
-                    }
+            }
+            if (shadowed) {
+                continue;
+            }
+            if (item->name == "++") {
+                // the section was just registered by the loop on the parents, only a new one is opened
+                if (layers.opened(path)) {
+                    opened.insert(path);
+                    output.push_back(std::move(*item));
+                }
+            }
+            else if (item->name == "--") {
+                if (opened.count(path) != 0) {
+                    output.push_back(std::move(*item));
+                }
+            }
+            else {
+                Layers::append(path, item->name);
+                if (layers.value(path) == Layers::Layer::New) {
+                    output.push_back(std::move(*item));
+                }
+            }
+        }
+        layers.next_document();
+    }
+    return output;
+}
 
-                    for (auto ci: parse(it->second, tmp)) {
-                        output.push_back(std::move(ci));
-                    }
+template <typename Output>
+void
+ConfigYAML::parse(const YAML::Node& node, std::vector<std::string>& parents, Output& output,
+        Layers* layers, const std::function<bool(const std::string&)>* load_section) const
+{
+    // the maps and the sequences being walked, the key of a frame is left and its section closed at its end
+    struct Frame {
+        YAML::Node node;
+        YAML::const_iterator it;
+        /// the scalars of a sequence, owned by the node, the item is added after the ones of the nested maps
+        std::vector<const std::string*> inputs;
+        /// the position of the output at the start of a map, for its aliases
+        std::size_t first;
+        bool entered;
+        bool section;
+    };
+    std::vector<Frame> frames;
 
-                    if (it->second.IsMap()) { // Only Map end a section (not a sequence)
-                        if (!output.empty() && output.rbegin()->name == "++") {
-                            output.pop_back();
-                        }
-                        else {
-                            ConfigItem config_item_close;
-                            config_item_close.name = "--";
-                            config_item_close.parents = tmp;
-                            output.push_back(std::move(config_item_close));
-                        }
-                    }
-                }
+    auto finish = [&](bool entered, bool section) {
+        if (section) { // Only Map end a section (not a sequence)
+            output.close(parents);
+        }
+        if (entered) {
+            output.leave();
+            parents.pop_back();
+        }
+    };
+    auto start = [&](const YAML::Node& child, bool entered, bool section) {
+        // the alias of a map already converted is not walked again, the layers need the items one by one
+        if (child.IsMap() && !(layers == nullptr && output.repeat(child))) {
+            frames.push_back(Frame{child, child.begin(), {}, output.position(), entered, section});
+        }
+        else if (child.IsSequence()) {
+            frames.push_back(Frame{child, child.begin(), {}, 0, entered, section});
+            frames.back().inputs.reserve(child.size());
+        }
+        else {
+            finish(entered, section);
+        }
+    };
+
+    start(node, false, false);
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        if (frame.it == frame.node.end()) {
+            if (frame.node.IsSequence()) {
+                output.sequence(parents, frame.inputs);
+            }
+            else if (layers == nullptr) {
+                output.record(frame.node, frame.first);
+            }
+            bool entered = frame.entered;
+            bool section = frame.section;
+            frames.pop_back();
+            finish(entered, section);
+            continue;
+        }
+
+        YAML::const_iterator it = frame.it++;
+        if (frame.node.IsSequence()) {
+            if (it->IsScalar()) {
+                frame.inputs.push_back(&it->Scalar());
+            }
+            else {
+                start(*it, false, false);
+            }
+            continue;
+        }
+
+        if (it->second.IsScalar()) {
+            std::string name = it->first.as<std::string>();
+            if (layers != nullptr && layers->value(Layers::path(parents, name)) != Layers::Layer::New) {
+                continue;
+            }
+
+            output.value(parents, std::move(name), it->second.Scalar(), it->second.Tag());
+            continue;
+        }
+        parents.push_back(it->first.as<std::string>());
+
+        // a top level section not needed yet is not converted at all
+        if (load_section != nullptr && frames.size() == 1 && parents.size() == 1 && it->second.IsMap()
+                && !(*load_section)(parents.front())) {
+            parents.pop_back();
+            continue;
+        }
+
+        // Only Map start a section (not a sequence), a later document may already have opened it
+        bool section = it->second.IsMap();
+        if (layers != nullptr && !it->second.IsNull()) {
+            auto path = Layers::path(parents);
+            auto layer = section ? layers->section(path) : layers->value(path);
+            if (layer == Layers::Layer::Shadowed) {
+                parents.pop_back();
+                continue;
             }
-            break;
+            section = section && layer == Layers::Layer::New;
+        }
+
+        output.enter(parents.back());
+        if (section) {
+            output.open(parents);
+        }
+        start(it->second, true, section);
+    }
+}
+
+// --------------------------------------------------------------------------
+std::string
+ConfigJSON::to_config(const App* app, bool default_also, bool, std::string prefix) const
+{
+    std::stringstream out;
+    ConfigWriter<JSONEmitter> writer{out, default_also, false};
+    writer.write(app, prefix.empty() ? std::vector<std::string>{} : detail::split(prefix, '.'));
+    return out.str();
+}
+
+std::vector<ConfigItem>
+ConfigJSON::from_config(std::istream& is) const
+{
+    std::string text = read_all(is);
+    return from_buffer(text.data(), text.size());
+}
+
+std::vector<ConfigItem>
+ConfigJSON::from_buffer(const char* data, std::size_t size) const
+{
+    std::vector<ConfigItem> output;
+    ItemOutput items{output};
+    JSONParser<ItemOutput>{std::string_view{data, size}, items}.parse();
+    return output;
+}
+
+CompactConfig
+ConfigJSON::from_config_compact(std::istream& is) const
+{
+    std::string text = read_all(is);
+    CompactConfig output;
+    CompactOutput items{output};
+    JSONParser<CompactOutput>{text, items}.parse();
+    return output;
+}
+
+CompactConfig
+ConfigJSON::from_file_compact(const std::string& name, const std::function<bool(const std::string&)>&) const
+{
+    detail::MappedFile file;
+    if (file.open(name)) {
+        CompactConfig output;
+        CompactOutput items{output};
+        JSONParser<CompactOutput>{std::string_view{file.data(), file.size()}, items}.parse();
+        return output;
+    }
+    std::ifstream input{name};
+    if (!input.good()) {
+        throw FileError::Missing(name);
+    }
+    return from_config_compact(input);
+}
+
+bool
+ConfigJSON::supports_compact() const
+{
+#if CLI11_USE_STATIC_RTTI == 0
+    return typeid(*this) == typeid(ConfigJSON);
+#else
+    return false;
+#endif
+}
+
+// --------------------------------------------------------------------------
+std::string
+ConfigBinary::encode(const std::vector<ConfigItem>& items)
+{
+    return encode(CompactConfig(items));
+}
+
+std::string
+ConfigBinary::encode(const CompactConfig& items)
+{
+    // only the sections holding items are written, numbered in the order of the paths so a parent comes first
+    std::vector<std::uint32_t> sections_of_paths(items.path_count(), 0);
+    for (const auto& item: items.items()) {
+        for (auto path = item.path; path != CompactConfig::root && sections_of_paths[path] == 0;
+                path = items.parent(path)) {
+            sections_of_paths[path] = 1;
+        }
+    }
+    binary_config::StringTable strings;
+    item_cache::Writer sections;
+    std::uint32_t section_count = 1;
+    for (CompactConfig::path_id path = 1; path < items.path_count(); ++path) {
+        if (sections_of_paths[path] != 0) {
+            sections_of_paths[path] = section_count++;
+            sections.put(sections_of_paths[items.parent(path)]);
+            sections.put(strings.add(items.name(path)));
+        }
+    }
+    item_cache::Writer records;
+    item_cache::Writer inputs;
+    std::uint32_t input_count = 0;
+    for (const auto& item: items.items()) {
+        records.put(sections_of_paths[item.path]);
+        records.put(strings.add(item.name));
+        records.put(input_count);
+        records.put(item.input_count);
+        records.put(static_cast<std::uint8_t>(item.value.type));
+        records.put(static_cast<std::uint8_t>(item.value.boolean ? 1 : 0));
+        records.put(item.value.integer);
+        records.put(item.value.real);
+        for (std::uint32_t i = 0; i < item.input_count; ++i) {
+            inputs.put(strings.add(items.inputs(item)[i]));
+        }
+        input_count += item.input_count;
+    }
+    if (strings.str().size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw ConfigError("binary config: more than 4GiB of strings");
+    }
+
+    item_cache::Writer header;
+    for (char c: binary_config::magic) {
+        header.put(c);
+    }
+    header.put(binary_config::byte_order);
+    header.put(section_count);
+    header.put(static_cast<std::uint32_t>(items.size()));
+    header.put(input_count);
+    header.put(static_cast<std::uint32_t>(strings.str().size()));
+    return header.str() + strings.str() + sections.str() + records.str() + inputs.str();
+}
+
+std::string
+ConfigBinary::to_config(const App* app, bool default_also, bool, std::string prefix) const
+{
+    ConfigYAML yaml;
+    std::stringstream text{yaml.to_config(app, default_also, false, std::move(prefix))};
+    return encode(yaml.from_config_compact(text));
+}
+
+std::vector<ConfigItem>
+ConfigBinary::from_config(std::istream& is) const
+{
+    std::string data = read_all(is);
+    return from_buffer(data.data(), data.size());
+}
+
+std::vector<ConfigItem>
+ConfigBinary::from_buffer(const char* data, std::size_t size) const
+{
+    return decode(data, size).to_items();
+}
+
+CompactConfig
+ConfigBinary::from_config_compact(std::istream& is) const
+{
+    std::string data = read_all(is);
+    return decode(data.data(), data.size());
+}
+
+CompactConfig
+ConfigBinary::from_file_compact(const std::string& name, const std::function<bool(const std::string&)>&) const
+{
+    detail::MappedFile file;
+    if (file.open(name)) {
+        return decode(file.data(), file.size());
+    }
+    std::ifstream input{name, std::ios::binary};
+    if (!input.good()) {
+        throw FileError::Missing(name);
+    }
+    return from_config_compact(input);
+}
+
+bool
+ConfigBinary::supports_compact() const
+{
+#if CLI11_USE_STATIC_RTTI == 0
+    return typeid(*this) == typeid(ConfigBinary);
+#else
+    return false;
+#endif
+}
+
+CompactConfig
+ConfigBinary::decode(const char* data, std::size_t size)
+{
+    auto invalid = []() { return ConfigError("binary config: invalid or truncated file"); };
+    if (size < sizeof(binary_config::magic)
+            || std::memcmp(data, binary_config::magic, sizeof(binary_config::magic)) != 0) {
+        throw ConfigError("binary config: not a binary configuration");
+    }
+    item_cache::Reader reader{data + sizeof(binary_config::magic), size - sizeof(binary_config::magic)};
+    std::uint32_t order{0};
+    std::uint32_t section_count{0};
+    std::uint32_t item_count{0};
+    std::uint32_t input_count{0};
+    std::uint32_t string_bytes{0};
+    if (!reader.get(order) || !reader.get(section_count) || !reader.get(item_count) || !reader.get(input_count)
+            || !reader.get(string_bytes)) {
+        throw invalid();
+    }
+    if (order != binary_config::byte_order) {
+        throw ConfigError("binary config: written with another byte order");
+    }
+
+    // the sizes of all the tables are checked first, the reads below only check the offsets
+    constexpr std::size_t section_size = 2 * sizeof(std::uint32_t);
+    constexpr std::size_t item_size = 4 * sizeof(std::uint32_t) + 2 + sizeof(std::int64_t) + sizeof(double);
+    const std::size_t header_size = sizeof(binary_config::magic) + 5 * sizeof(std::uint32_t);
+    if (section_count == 0
+            || size != header_size + string_bytes + (section_count - std::size_t{1}) * section_size
+                    + std::size_t{item_count} * item_size + std::size_t{input_count} * sizeof(std::uint32_t)) {
+        throw invalid();
+    }
+    const char* strings = data + header_size;
+    auto string = [strings, string_bytes, &invalid](std::uint32_t offset) {
+        std::uint32_t length{0};
+        if (std::size_t{offset} + sizeof(length) > string_bytes) {
+            throw invalid();
+        }
+        std::memcpy(&length, strings + offset, sizeof(length));
+        if (std::size_t{offset} + sizeof(length) + length > string_bytes) {
+            throw invalid();
+        }
+        return std::string_view{strings + offset + sizeof(length), length};
+    };
+    item_cache::Reader tables{strings + string_bytes, size - header_size - string_bytes};
+
+    CompactConfig output;
+    // the ids given by the output are the indices of the file unless a section is written twice
+    std::vector<CompactConfig::path_id> paths(section_count, CompactConfig::root);
+    for (std::uint32_t section = 1; section < section_count; ++section) {
+        std::uint32_t parent{0};
+        std::uint32_t name{0};
+        tables.get(parent);
+        tables.get(name);
+        if (parent >= section) {
+            throw invalid();
         }
-        case YAML::NodeType::Undefined:
-            break;
-        default:
-            break;
+        paths[section] = output.path(paths[parent], string(name));
     }
 
+    const char* inputs = strings + string_bytes + (section_count - std::size_t{1}) * section_size
+                         + std::size_t{item_count} * item_size;
+    for (std::uint32_t index = 0; index < item_count; ++index) {
+        std::uint32_t section{0};
+        std::uint32_t name{0};
+        std::uint32_t first{0};
+        std::uint32_t count{0};
+        std::uint8_t type{0};
+        std::uint8_t boolean{0};
+        ConfigValue value;
+        tables.get(section);
+        tables.get(name);
+        tables.get(first);
+        tables.get(count);
+        tables.get(type);
+        tables.get(boolean);
+        tables.get(value.integer);
+        tables.get(value.real);
+        if (section >= section_count || std::size_t{first} + count > input_count
+                || type > static_cast<std::uint8_t>(ConfigValue::value_type::string)) {
+            throw invalid();
+        }
+        value.type = static_cast<ConfigValue::value_type>(type);
+        value.boolean = boolean != 0;
+        output.add(paths[section], string(name));
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            std::uint32_t offset{0};
+            std::memcpy(&offset, inputs + std::size_t{i} * sizeof(offset), sizeof(offset));
+            output.add_input(string(offset));
+        }
+        output.set_value(value);
+    }
     return output;
 }
 
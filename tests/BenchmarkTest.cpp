@@ -0,0 +1,574 @@
+// Copyright (c) 2017-2022, University of Cincinnati, developed by Henry Schreiner
+// under NSF AWARD 1414736 and by the respective contributors.
+// All rights reserved.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "app_helper.hpp"
+
+#include <cli11-yaml/cli11-yaml.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Count the heap allocations of the whole test program, only read while a test measures them
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if(void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+// every form is replaced, an allocation done by one that is not, as Catch does with new (std::nothrow), would
+// otherwise be given to std::free
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    ++allocation_count;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#ifdef __cpp_aligned_new
+namespace {
+void* aligned_allocate(std::size_t size, std::align_val_t alignment) noexcept {
+    ++allocation_count;
+    auto align = static_cast<std::size_t>(alignment);
+    // the size of aligned_alloc is a multiple of the alignment
+    size = (size == 0 ? align : (size + align - 1) / align * align);
+#ifdef _WIN32
+    return _aligned_malloc(size, align);
+#else
+    return std::aligned_alloc(align, size);
+#endif
+}
+
+void aligned_free(void* ptr) noexcept {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+}  // namespace
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if(void* ptr = aligned_allocate(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return aligned_allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return aligned_allocate(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept { aligned_free(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept { aligned_free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { aligned_free(ptr); }
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { aligned_free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { aligned_free(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { aligned_free(ptr); }
+#endif
+
+namespace {
+
+/// Count the allocations done by a callable
+template <typename F> std::size_t count_allocations(F&& func) {
+    auto start = allocation_count.load();
+    func();
+    return allocation_count.load() - start;
+}
+
+/// Write a document of nested maps with `keys` scalars and `branches` sub maps per map, down to `depth` levels
+void write_nested_yaml(std::ostream& out, int depth, int keys, int branches, int indent = 0) {
+    std::string pad(static_cast<std::size_t>(indent), ' ');
+    for(int k = 0; k < keys; ++k) {
+        out << pad << "key" << k << ": " << k << '\n';
+    }
+    if(depth > 1) {
+        for(int b = 0; b < branches; ++b) {
+            out << pad << "level" << depth << "_" << b << ":\n";
+            write_nested_yaml(out, depth - 1, keys, branches, indent + 2);
+        }
+    }
+}
+
+/// 10 levels of maps with 49 keys each and 2 sub maps, so 50127 scalar keys in 1023 maps
+std::string nested_yaml_document() {
+    std::stringstream out;
+    write_nested_yaml(out, 10, 49, 2);
+    return out.str();
+}
+
+/// 64 top level sections of 6 levels of nested maps, for the conversion split at the top level keys
+std::string sectioned_yaml_document() {
+    std::stringstream out;
+    for(int s = 0; s < 64; ++s) {
+        out << "section" << s << ":\n";
+        write_nested_yaml(out, 6, 25, 2, 2);
+    }
+    return out.str();
+}
+
+/// The nested maps of write_nested_yaml as JSON objects
+void write_nested_json(std::ostream& out, int depth, int keys, int branches) {
+    out << '{';
+    for(int k = 0; k < keys; ++k) {
+        out << (k == 0 ? "" : ",") << "\n\"key" << k << "\": " << k;
+    }
+    if(depth > 1) {
+        for(int b = 0; b < branches; ++b) {
+            out << ",\n\"level" << depth << "_" << b << "\": ";
+            write_nested_json(out, depth - 1, keys, branches);
+        }
+    }
+    out << '}';
+}
+
+std::string nested_json_document() {
+    std::stringstream out;
+    write_nested_json(out, 10, 49, 2);
+    return out.str();
+}
+
+}  // namespace
+
+TEST_CASE("Yaml: Allocations: NestedParse", "[config]") {
+    std::string document = nested_yaml_document();
+
+    std::vector<CLI::ConfigItem> output;
+    auto parse_allocations = count_allocations([&document, &output]() {
+        std::stringstream input{document};
+        output = CLI::ConfigYAML().scanner(false)->from_config(input);
+    });
+    auto load_allocations = count_allocations([&document]() {
+        std::stringstream input{document};
+        auto node = YAML::Load(input);
+    });
+
+    REQUIRE(output.size() > 50000U);
+    REQUIRE(parse_allocations > load_allocations);
+    // each leaf only needs its parents and inputs vectors, the names are all in the small string buffer
+    auto per_item = static_cast<double>(parse_allocations - load_allocations) / static_cast<double>(output.size());
+    CAPTURE(parse_allocations, load_allocations);
+    CHECK(per_item < 3.0);
+}
+
+TEST_CASE("Yaml: Allocations: NestedParseScanner", "[config]") {
+    std::string document = nested_yaml_document();
+
+    std::vector<CLI::ConfigItem> output;
+    auto scan_allocations = count_allocations([&document, &output]() {
+        std::stringstream input{document};
+        output = CLI::ConfigYAML().from_config(input);
+    });
+    auto load_allocations = count_allocations([&document]() {
+        std::stringstream input{document};
+        auto node = YAML::Load(input);
+    });
+
+    REQUIRE(output.size() > 50000U);
+    // the scanner does not build the nodes of yaml-cpp, only the items are allocated
+    CAPTURE(scan_allocations, load_allocations);
+    CHECK(scan_allocations < load_allocations);
+}
+
+TEST_CASE("Yaml: Allocations: NestedParseCompact", "[config]") {
+    std::string document = nested_yaml_document();
+
+    std::vector<CLI::ConfigItem> output;
+    auto item_allocations = count_allocations([&document, &output]() {
+        std::stringstream input{document};
+        output = CLI::ConfigYAML().from_config(input);
+    });
+    CLI::CompactConfig compact;
+    auto compact_allocations = count_allocations([&document, &compact]() {
+        std::stringstream input{document};
+        compact = CLI::ConfigYAML().from_config_compact(input);
+    });
+
+    REQUIRE(compact.size() == output.size());
+    // the parents and inputs of the leaves are no longer allocated one by one
+    CAPTURE(item_allocations, compact_allocations);
+    CHECK(compact_allocations + output.size() < item_allocations);
+}
+
+TEST_CASE("App: Allocations: ParseArguments", "[config]") {
+    CLI::App app{"Long arguments"};
+    std::vector<std::string> values;
+    std::vector<std::string> extras;
+    app.add_option("--values", values);
+    app.add_option("extras", extras);
+
+    // arguments too long for the small string buffer, in the reverse order of parse
+    std::vector<std::string> args;
+    for(int i = 0; i < 1000; ++i) {
+        args.push_back("a positional argument longer than a small string " + std::to_string(i));
+    }
+    args.emplace_back("--values");
+    for(int i = 0; i < 1000; ++i) {
+        args.push_back("an option value longer than a small string " + std::to_string(i));
+    }
+
+    auto input = args;
+    app.parse(input);
+    REQUIRE(values.size() == 1000U);
+    REQUIRE(extras.size() == 1000U);
+
+    input = args;
+    auto parse_allocations = count_allocations([&app, &input]() { app.parse(input); });
+    // the arguments are moved to the results, only copied once more by the conversion to the bound vectors
+    CAPTURE(parse_allocations);
+    CHECK(parse_allocations < 2U * args.size() + 200U);
+}
+
+TEST_CASE("App: Allocations: ParseContext", "[config]") {
+    CLI::App app{"Request server"};
+    int port{0};
+    std::string host;
+    int verbose{0};
+    int level{0};
+    std::vector<std::string> files;
+    app.add_option("-p,--port", port)->check(CLI::Range(1, 65535));
+    app.add_option("--host", host);
+    app.add_flag("-v,--verbose", verbose);
+    auto *run = app.add_subcommand("run");
+    run->add_option("-l,--level", level);
+    run->add_option("files", files);
+
+    const char *argv[] = {"server", "--port", "8080", "--host=web1", "-vv", "run", "-l", "3", "a.txt", "b.txt"};
+    const int argc = static_cast<int>(sizeof(argv) / sizeof(argv[0]));
+
+    CLI::ParseContext context;
+    app.parse(argc, argv, context);
+    app.parse(argc, argv, context);
+
+    // the buffers of the context and of the previous parse are reused, the arguments fit in the small string buffer
+    auto parse_allocations = count_allocations([&app, &argc, &argv, &context]() { app.parse(argc, argv, context); });
+    CAPTURE(parse_allocations);
+    CHECK(parse_allocations == 0U);
+
+    CHECK(port == 8080);
+    CHECK(host == "web1");
+    CHECK(verbose == 2);
+    CHECK(level == 3);
+    CHECK(files == std::vector<std::string>{"a.txt", "b.txt"});
+    CHECK(app.parse_order().size() == 4U);
+}
+
+TEST_CASE("Yaml: Benchmark: NestedParse", "[config][!benchmark]") {
+    std::string document = nested_yaml_document();
+
+    BENCHMARK("ConfigYAML node") {
+        std::stringstream input{document};
+        return CLI::ConfigYAML().scanner(false)->from_config(input);
+    };
+
+    BENCHMARK("ConfigYAML scanner") {
+        std::stringstream input{document};
+        return CLI::ConfigYAML().from_config(input);
+    };
+
+    BENCHMARK("ConfigYAML streaming") {
+        std::stringstream input{document};
+        return CLI::ConfigYAML().streaming()->from_config(input);
+    };
+
+    BENCHMARK("ConfigYAML compact") {
+        std::stringstream input{document};
+        return CLI::ConfigYAML().from_config_compact(input);
+    };
+}
+
+TEST_CASE("Yaml: Benchmark: Aliases", "[config][!benchmark]") {
+    // a map of 1000 keys anchored once and referenced 200 times
+    std::stringstream out;
+    out << "defaults: &defaults\n";
+    for(int k = 0; k < 1000; ++k) {
+        out << "  key" << k << ": " << k << '\n';
+    }
+    for(int r = 0; r < 200; ++r) {
+        out << "ref" << r << ": *defaults\n";
+    }
+    std::string document = out.str();
+
+    std::stringstream input{document};
+    CHECK(CLI::ConfigYAML().from_config_compact(input).size() > 200000U);
+
+    BENCHMARK("ConfigYAML items") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().from_config(stream);
+    };
+
+    BENCHMARK("ConfigYAML compact") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().from_config_compact(stream);
+    };
+}
+
+TEST_CASE("Yaml: Benchmark: Parallel", "[config][!benchmark]") {
+    std::string document = sectioned_yaml_document();
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 2U);
+
+    std::stringstream input{document};
+    auto expected = CLI::ConfigYAML().from_config(input);
+    std::stringstream parallel_input{document};
+    auto output = CLI::ConfigYAML().parallel(threads)->from_config(parallel_input);
+    REQUIRE(output.size() == expected.size());
+    for(std::size_t i = 0; i < output.size(); i += 997) {
+        CHECK(output[i].fullname() == expected[i].fullname());
+        CHECK(output[i].inputs == expected[i].inputs);
+    }
+
+    BENCHMARK("ConfigYAML scanner") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().from_config_compact(stream);
+    };
+
+    BENCHMARK("ConfigYAML scanner parallel") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().parallel(threads)->from_config_compact(stream);
+    };
+
+    BENCHMARK("ConfigYAML node") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().scanner(false)->from_config_compact(stream);
+    };
+
+    BENCHMARK("ConfigYAML node parallel") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().scanner(false)->parallel(threads)->from_config_compact(stream);
+    };
+}
+
+TEST_CASE("Json: Benchmark: NestedParse", "[config][!benchmark]") {
+    std::string document = nested_json_document();
+
+    std::stringstream input{document};
+    auto output = CLI::ConfigJSON().from_config(input);
+    CHECK(output.size() > 50000U);
+
+    BENCHMARK("ConfigJSON") { return CLI::ConfigJSON().from_buffer(document.data(), document.size()); };
+
+    BENCHMARK("ConfigJSON compact") {
+        std::stringstream stream{document};
+        return CLI::ConfigJSON().from_config_compact(stream);
+    };
+
+    BENCHMARK("ConfigYAML on the JSON document") {
+        std::stringstream stream{document};
+        return CLI::ConfigYAML().from_config(stream);
+    };
+}
+
+TEST_CASE("Binary: Allocations: NestedParse", "[config]") {
+    std::string document = nested_yaml_document();
+    std::stringstream yaml{document};
+    std::string binary = CLI::ConfigBinary::encode(CLI::ConfigYAML().from_config_compact(yaml));
+
+    CLI::CompactConfig compact;
+    auto decode_allocations = count_allocations([&binary, &compact]() {
+        std::stringstream input{binary};
+        compact = CLI::ConfigBinary().from_config_compact(input);
+    });
+    auto load_allocations = count_allocations([&document]() {
+        std::stringstream input{document};
+        auto node = YAML::Load(input);
+    });
+
+    REQUIRE(compact.size() > 50000U);
+    // the strings are copied into the arena of the items, the tables are read in place
+    CAPTURE(decode_allocations, load_allocations);
+    CHECK(decode_allocations * 100 < load_allocations);
+}
+
+TEST_CASE("Binary: Benchmark: NestedParse", "[config][!benchmark]") {
+    std::string document = nested_yaml_document();
+    std::stringstream yaml{document};
+    std::string binary = CLI::ConfigBinary::encode(CLI::ConfigYAML().from_config_compact(yaml));
+
+    BENCHMARK("YAML::Load") {
+        std::stringstream input{document};
+        return YAML::Load(input);
+    };
+
+    BENCHMARK("ConfigBinary compact") {
+        std::stringstream input{binary};
+        return CLI::ConfigBinary().from_config_compact(input);
+    };
+
+    BENCHMARK("ConfigBinary items") { return CLI::ConfigBinary().from_buffer(binary.data(), binary.size()); };
+}
+
+TEST_CASE("Yaml: Benchmark: ToConfig", "[config][!benchmark]") {
+    CLI::App app{"Many options"};
+    std::vector<int> values(10000);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int>(i);
+        app.add_option("--option" + std::to_string(i), values[i], "Option number " + std::to_string(i))
+            ->capture_default_str();
+    }
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+
+    CHECK_THAT(app.config_to_str(true, true), Catch::Matchers::ContainsSubstring("option9999: 9999"));
+
+    BENCHMARK("ConfigYAML to_config 10k options") { return app.config_to_str(true, true); };
+}
+
+TEST_CASE("Yaml: Benchmark: Decode", "[config][!benchmark]") {
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    {
+        std::ofstream out{tmpYaml};
+        for(int i = 0; i < 10000; ++i) {
+            out << "option" << i << ": " << i << '\n';
+        }
+    }
+
+    CLI::App app{"Many options"};
+    std::vector<int> values(10000);
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        app.add_option("--option" + std::to_string(i), values[i]);
+    }
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    app.config_formatter(yaml);
+
+    app.parse(std::vector<std::string>{});
+    CHECK(values[9999] == 9999);
+
+    BENCHMARK("ConfigYAML items 10k options") {
+        yaml->decode(false);
+        app.parse(std::vector<std::string>{});
+        return values[9999];
+    };
+
+    BENCHMARK("ConfigYAML decode 10k options") {
+        yaml->decode(true);
+        app.parse(std::vector<std::string>{});
+        return values[9999];
+    };
+}
+
+TEST_CASE("App: Benchmark: OptionLookup", "[!benchmark]") {
+    // the cost of finding an option should not grow with the number of options
+    for(int count : {100, 1000, 10000}) {
+        CLI::App app{"Many options"};
+        app.option_defaults()->ignore_case()->ignore_underscore();
+        std::vector<int> values(static_cast<std::size_t>(count));
+        for(int i = 0; i < count; ++i) {
+            app.add_option("--option_" + std::to_string(i), values[static_cast<std::size_t>(i)]);
+        }
+        // 100 of the options given on the command line, in the reverse order of parse
+        std::vector<std::string> args;
+        for(int i = 0; i < 100; ++i) {
+            args.push_back(std::to_string(i));
+            args.push_back("--OPTION" + std::to_string(count - 1 - i));
+        }
+        std::string last = "--OPTION" + std::to_string(count - 1);
+
+        auto input = args;
+        app.parse(input);
+        CHECK(values.back() == 0);
+        CHECK(values[static_cast<std::size_t>(count - 100)] == 99);
+        CHECK(app.get_option_no_throw(last) != nullptr);
+
+        BENCHMARK("parse 100 of " + std::to_string(count) + " options") {
+            input = args;
+            app.parse(input);
+            return values.back();
+        };
+
+        BENCHMARK("get_option of " + std::to_string(count) + " options") { return app.get_option_no_throw(last); };
+    }
+}
+
+TEST_CASE("App: Benchmark: Registration", "[!benchmark]") {
+    // adding an option or a subcommand should not compare it with all the previous ones
+    BENCHMARK("add 20000 options") {
+        CLI::App app{"Many options"};
+        for(int i = 0; i < 20000; ++i) {
+            auto number = std::to_string(i);
+            app.add_option("--option_" + number + ",--alias" + number)->envname("OPTION" + number);
+        }
+        return app.get_options().size();
+    };
+
+    BENCHMARK("add 20000 subcommands") {
+        CLI::App app{"Many subcommands"};
+        auto *group = app.add_option_group("group");
+        for(int i = 0; i < 20000; ++i) {
+            group->add_subcommand("command" + std::to_string(i))->alias("c" + std::to_string(i));
+        }
+        return group->get_subcommands().size();
+    };
+}
+
+TEST_CASE("App: Benchmark: SubcommandDispatch", "[!benchmark]") {
+    // each argument is checked against the subcommands of every level before being taken as a positional
+    CLI::App app{"Many subcommands"};
+    CLI::App* level = &app;
+    for(int depth = 0; depth < 3; ++depth) {
+        CLI::App* next = nullptr;
+        for(int i = 0; i < 300; ++i) {
+            next = level->add_subcommand("command" + std::to_string(depth) + "_" + std::to_string(i));
+            next->alias("c" + std::to_string(depth) + "_" + std::to_string(i));
+        }
+        level = next;
+    }
+    std::vector<std::string> values;
+    level->add_option("values", values);
+
+    std::vector<std::string> args;
+    for(int i = 0; i < 1000; ++i) {
+        args.push_back("value" + std::to_string(i));
+    }
+    args.insert(args.end(), {"c2_299", "command1_299", "c0_299"});
+
+    auto input = args;
+    app.parse(input);
+    CHECK(values.size() == 1000U);
+
+    BENCHMARK("parse 1000 positionals under 3 levels of 300 subcommands") {
+        input = args;
+        app.parse(input);
+        return values.size();
+    };
+}
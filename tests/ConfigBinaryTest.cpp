@@ -0,0 +1,150 @@
+// Copyright (c) 2017-2022, University of Cincinnati, developed by Henry Schreiner
+// under NSF AWARD 1414736 and by the respective contributors.
+// All rights reserved.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "app_helper.hpp"
+
+#include <cli11-yaml/cli11-yaml.hpp>
+
+#include <cstdio>
+#include <sstream>
+
+TEST_CASE("Binary: StringBased: SameAsYaml", "[config]")
+{
+    std::vector<std::string> documents = {
+        "one: three\n"
+        "two: 4\n"
+        "real: 1.5\n"
+        "flag: true\n"
+        "quoted: \"12\"\n"
+        "list: [1, two, 3]\n"
+        "none: ~\n"
+        "sub:\n"
+        "  one: again\n"
+        "  deeper:\n"
+        "    val: 5\n"
+        "  empty: {}\n"
+        "other:\n"
+        "  sub:\n"
+        "    one: three\n",
+        "",
+        "one: 1\n"
+        "---\n"
+        "sub:\n"
+        "  two: 2\n",
+    };
+
+    for (const auto& document: documents) {
+        CAPTURE(document);
+        auto expected = CLI::ConfigYAML().from_config(Stream{document});
+        std::string binary = CLI::ConfigBinary::encode(expected);
+        auto output = CLI::ConfigBinary().from_config(Stream{binary});
+        REQUIRE(output.size() == expected.size());
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            CHECK(output[i].parents == expected[i].parents);
+            CHECK(output[i].name == expected[i].name);
+            CHECK(output[i].inputs == expected[i].inputs);
+            CHECK(output[i].value.type == expected[i].value.type);
+            CHECK(output[i].value.integer == expected[i].value.integer);
+            CHECK(output[i].value.real == expected[i].value.real);
+            CHECK(output[i].value.boolean == expected[i].value.boolean);
+        }
+
+        // the compact items give the same file
+        auto compact = CLI::ConfigYAML().from_config_compact(Stream{document});
+        CHECK(CLI::ConfigBinary::encode(compact) == binary);
+    }
+}
+
+TEST_CASE("Binary: StringBased: Errors", "[config]")
+{
+    std::string binary = CLI::ConfigBinary::encode(CLI::ConfigYAML().from_config(Stream{"one: 1\nsub:\n  two: 2\n"}));
+
+    CHECK_THROWS_AS(CLI::ConfigBinary().from_config(Stream{"one: 1\n"}), CLI::ConfigError);
+    for (std::size_t size: {std::size_t{4}, std::size_t{20}, binary.size() - 1}) {
+        CAPTURE(size);
+        CHECK_THROWS_AS(CLI::ConfigBinary().from_buffer(binary.data(), size), CLI::ConfigError);
+    }
+    CHECK_THROWS_AS(CLI::ConfigBinary().from_config(Stream{binary + "x"}), CLI::ConfigError);
+
+    // an offset of the string table out of range
+    std::string corrupted = binary;
+    std::uint32_t offset = 0xffff;
+    corrupted.replace(corrupted.size() - sizeof(offset), sizeof(offset), reinterpret_cast<const char*>(&offset),
+            sizeof(offset));
+    CHECK_THROWS_AS(CLI::ConfigBinary().from_config(Stream{corrupted}), CLI::ConfigError);
+}
+
+TEST_CASE_METHOD(TApp, "BinaryCompiledYaml", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    TempFile tmpBinary{"TestBinaryTmp.cfgb"};
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "flag: true" << std::endl;
+        out << "list: [1, 2, 3]" << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: 2" << std::endl;
+        out << "  name: text" << std::endl;
+    }
+    {
+        std::ofstream out{tmpBinary, std::ios::binary};
+        out << CLI::ConfigBinary::encode(CLI::ConfigYAML().from_file(tmpYaml));
+    }
+
+    app.set_config("--config", tmpBinary);
+    app.config_formatter(std::make_shared<CLI::ConfigBinary>());
+
+    int one{0}, two{0};
+    bool flag{false};
+    std::vector<int> list;
+    std::string name;
+    app.add_option("--val", one);
+    app.add_flag("--flag", flag);
+    app.add_option("--list", list);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+    subcom->add_option("--name", name);
+
+    run();
+
+    CHECK(one == 1);
+    CHECK(flag);
+    CHECK(list == std::vector<int>{1, 2, 3});
+    CHECK(two == 2);
+    CHECK(name == "text");
+}
+
+TEST_CASE_METHOD(TApp, "BinaryOutputRoundTrip", "[config]")
+{
+    int one{1};
+    std::vector<std::string> values{"a", "b c"};
+    app.add_option("--one", one)->capture_default_str();
+    app.add_option("--values", values)->capture_default_str();
+    auto* subcom = app.add_subcommand("subcom");
+    double two{2.5};
+    subcom->add_option("--two", two)->capture_default_str();
+    app.config_formatter(std::make_shared<CLI::ConfigBinary>());
+
+    args = {"--one", "5", "subcom", "--two", "6.5"};
+    run();
+
+    TempFile tmpBinary{"TestBinaryTmp.cfgb"};
+    {
+        std::ofstream out{tmpBinary, std::ios::binary};
+        out << app.config_to_str(true, false);
+    }
+    one = 0;
+    two = 0;
+    values.clear();
+    app.set_config("--config", tmpBinary);
+    args = {"subcom"};
+    run();
+    CHECK(one == 5);
+    CHECK(values == std::vector<std::string>{"a", "b c"});
+    CHECK(two == 6.5);
+}
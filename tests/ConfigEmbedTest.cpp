@@ -0,0 +1,73 @@
+// Copyright (c) 2017-2022, University of Cincinnati, developed by Henry Schreiner
+// under NSF AWARD 1414736 and by the respective contributors.
+// All rights reserved.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "app_helper.hpp"
+
+#include <cli11-yaml/cli11-yaml.hpp>
+
+// generated from embedded_defaults.yaml by cli11_yaml_embed
+#include <embedded_defaults.hpp>
+
+#include <cstdio>
+
+TEST_CASE("Embed: SameAsYaml", "[config]")
+{
+    std::ifstream input{EMBEDDED_DEFAULTS_YAML};
+    auto expected = CLI::ConfigYAML().from_config(input);
+
+    auto output = CLI::CompactConfig(embedded_defaults).to_items();
+    REQUIRE(output.size() == expected.size());
+    for (std::size_t i = 0; i < output.size(); ++i) {
+        CHECK(output[i].parents == expected[i].parents);
+        CHECK(output[i].name == expected[i].name);
+        CHECK(output[i].inputs == expected[i].inputs);
+        CHECK(output[i].value.type == expected[i].value.type);
+        CHECK(output[i].value.integer == expected[i].value.integer);
+        CHECK(output[i].value.real == expected[i].value.real);
+    }
+}
+
+TEST_CASE_METHOD(TApp, "EmbeddedDefaults", "[config]")
+{
+    int val{0}, subval{0};
+    std::string name;
+    double real{0.0};
+    std::vector<int> list;
+    bool flag{false};
+    app.add_option("--val", val);
+    app.add_option("--name", name);
+    app.add_option("--real", real)->envname("CLI11_EMBED_REAL");
+    app.add_option("--list", list);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", subval);
+    subcom->add_flag("--flag", flag);
+    app.config_defaults(embedded_defaults);
+
+    run();
+    CHECK(val == 1);
+    CHECK(name == "quoted \"name\"");
+    CHECK(real == 2.5);
+    CHECK(list == std::vector<int>{1, 2, 3});
+    CHECK(subval == 2);
+    CHECK(flag);
+
+    // the command line and the config files take precedence, as a later config file
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    {
+        std::ofstream out{tmpYaml};
+        out << "name: file" << std::endl;
+    }
+    app.set_config("--config", tmpYaml);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    put_env("CLI11_EMBED_REAL", "3.5");
+    args = {"--val", "5"};
+    run();
+    unset_env("CLI11_EMBED_REAL");
+    CHECK(val == 5);
+    CHECK(name == "file");
+    // the environment comes after the configuration
+    CHECK(real == 2.5);
+}
@@ -435,6 +435,91 @@ TEST_CASE("StringBased: file_error", "[config]") {
     CHECK_THROWS_AS(CLI::ConfigINI().from_file("nonexist_file"), CLI::FileError);
 }
 
+TEST_CASE("StringBased: file_mapped", "[config]") {
+    TempFile tmpini{"TestIniTmp.ini"};
+
+    std::string document = "one=three\n[other]\ntwo=[four, five]\n";
+    {
+        std::ofstream out{tmpini};
+        out << document;
+    }
+
+    std::vector<CLI::ConfigItem> output = CLI::ConfigINI().from_file(tmpini);
+    std::vector<CLI::ConfigItem> buffered = CLI::ConfigINI().from_buffer(document.data(), document.size());
+
+    CHECK(output.size() == 4u);
+    REQUIRE(buffered.size() == output.size());
+    for(std::size_t i = 0; i < output.size(); ++i) {
+        CHECK(buffered[i].fullname() == output[i].fullname());
+        CHECK(buffered[i].inputs == output[i].inputs);
+    }
+    CHECK(output.at(2).fullname() == "other.two");
+    CHECK(output.at(2).inputs == std::vector<std::string>({"four", "five"}));
+}
+
+TEST_CASE("StringBased: compact", "[config]") {
+    std::string document = "simple = true\n"
+                           "[other.sub2]\n"
+                           "one = 1\n"
+                           "one = 2\n"
+                           "[other.sub2.sub-level2]\n"
+                           "two = [3, 4]\n"
+                           "[other.sub3]\n"
+                           "three = 5\n";
+
+    std::stringstream input{document};
+    std::vector<CLI::ConfigItem> output = CLI::ConfigINI().from_config(input);
+    std::stringstream compact_input{document};
+    CLI::CompactConfig compact = CLI::ConfigINI().from_config_compact(compact_input);
+
+    std::vector<CLI::ConfigItem> converted = compact.to_items();
+    REQUIRE(converted.size() == output.size());
+    for(std::size_t i = 0; i < output.size(); ++i) {
+        CHECK(converted[i].fullname() == output[i].fullname());
+        CHECK(converted[i].inputs == output[i].inputs);
+    }
+    // root, other, other.sub2, other.sub2.sub-level2 and other.sub3
+    CHECK(compact.path_count() == 5u);
+    CHECK(compact.depth(compact.items().back().path) == 1u);
+}
+
+namespace {
+/// An INI format changing the values it reads, its files must not be read by the compact path of ConfigINI
+class ConfigINIRewrite : public CLI::ConfigINI {
+  public:
+    std::vector<CLI::ConfigItem> from_config(std::istream &input) const override {
+        std::vector<CLI::ConfigItem> items = CLI::ConfigINI::from_config(input);
+        for(auto &item : items) {
+            if(item.name == "val") {
+                item.inputs = {"42"};
+            }
+        }
+        return items;
+    }
+};
+}  // namespace
+
+TEST_CASE_METHOD(TApp, "IniDerivedFromConfig", "[config]") {
+    TempFile tmpini{"TestIniTmp.ini"};
+
+    app.set_config("--config", tmpini);
+    app.config_formatter(std::make_shared<ConfigINIRewrite>());
+
+    {
+        std::ofstream out{tmpini};
+        out << "val=1" << std::endl;
+    }
+
+    int val{0};
+    app.add_option("--val", val);
+    run();
+    CHECK(val == 42);
+#ifdef CLI11_CPP17
+    CHECK(CLI::ConfigINI().supports_compact() == (CLI11_USE_STATIC_RTTI == 0));
+    CHECK(!ConfigINIRewrite().supports_compact());
+#endif
+}
+
 TEST_CASE_METHOD(TApp, "IniNotRequired", "[config]") {
 
     TempFile tmpini{"TestIniTmp.ini"};
@@ -595,6 +680,68 @@ TEST_CASE_METHOD(TApp, "IniNotRequiredbadConfigurator", "[config]") {
     REQUIRE_NOTHROW(run());
 }
 
+/// Give typed values which do not match the inputs, to see which of them reached the variables
+class TypedConfig : public CLI::Config {
+  public:
+    std::string to_config(const CLI::App *, bool, bool, std::string) const override { return {}; }
+
+    std::vector<CLI::ConfigItem> from_config(std::istream &) const override {
+        std::vector<CLI::ConfigItem> items(5);
+        items[0].name = "integer";
+        items[0].inputs = {"1"};
+        items[0].value.type = CLI::ConfigValue::value_type::integer;
+        items[0].value.integer = 42;
+        items[1].name = "real";
+        items[1].inputs = {"1.5"};
+        items[1].value.type = CLI::ConfigValue::value_type::real;
+        items[1].value.real = 2.5;
+        items[2].name = "small";
+        items[2].inputs = {"7"};
+        items[2].value.type = CLI::ConfigValue::value_type::integer;
+        items[2].value.integer = 300;
+        items[3].name = "checked";
+        items[3].inputs = {"3"};
+        items[3].value.type = CLI::ConfigValue::value_type::integer;
+        items[3].value.integer = 4;
+        items[4].name = "untyped";
+        items[4].inputs = {"5"};
+        return items;
+    }
+};
+
+TEST_CASE_METHOD(TApp, "IniTypedValues", "[config]") {
+
+    TempFile tmpini{"TestIniTmp.ini"};
+    {
+        std::ofstream out{tmpini};
+        out << "typed" << std::endl;
+    }
+
+    app.set_config("--config", tmpini);
+    app.config_formatter(std::make_shared<TypedConfig>());
+    int integer{0};
+    double real{0.0};
+    std::int8_t small{0};
+    int checked{0};
+    int untyped{0};
+    auto *integer_option = app.add_option("--integer", integer);
+    app.add_option("--real", real);
+    app.add_option("--small", small);
+    app.add_option("--checked", checked)->check(CLI::Range(0, 10));
+    app.add_option("--untyped", untyped);
+
+    run();
+
+    // the typed values are assigned, the inputs stay the results of the options
+    CHECK(integer == 42);
+    CHECK(integer_option->as<std::string>() == "1");
+    CHECK(real == 2.5);
+    // out of range or with validators the inputs are converted
+    CHECK(small == 7);
+    CHECK(checked == 3);
+    CHECK(untyped == 5);
+}
+
 TEST_CASE_METHOD(TApp, "IniNotRequiredNotDefault", "[config]") {
 
     TempFile tmpini{"TestIniTmp.ini"};
@@ -0,0 +1,178 @@
+// Copyright (c) 2017-2022, University of Cincinnati, developed by Henry Schreiner
+// under NSF AWARD 1414736 and by the respective contributors.
+// All rights reserved.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "app_helper.hpp"
+
+#include <cli11-yaml/cli11-yaml.hpp>
+
+#include <cstdio>
+#include <sstream>
+
+namespace {
+
+/// Check the items of a JSON document against the ones ConfigYAML gives for it
+void
+check_same_as_yaml(const std::string& document)
+{
+    CAPTURE(document);
+    auto expected = CLI::ConfigYAML().from_config(Stream{document});
+    auto output = CLI::ConfigJSON().from_config(Stream{document});
+    REQUIRE(output.size() == expected.size());
+    for (std::size_t i = 0; i < output.size(); ++i) {
+        CHECK(output[i].parents == expected[i].parents);
+        CHECK(output[i].name == expected[i].name);
+        CHECK(output[i].inputs == expected[i].inputs);
+        CHECK(output[i].value.type == expected[i].value.type);
+    }
+
+    auto compact = CLI::ConfigJSON().from_config_compact(Stream{document}).to_items();
+    REQUIRE(compact.size() == expected.size());
+    for (std::size_t i = 0; i < compact.size(); ++i) {
+        CHECK(compact[i].fullname() == expected[i].fullname());
+        CHECK(compact[i].inputs == expected[i].inputs);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Json: StringBased: SameAsYaml", "[config]")
+{
+    check_same_as_yaml("{\"one\": \"three\", \"two\": 4, \"three\": 1.5e3, \"flag\": true, \"none\": null}");
+    check_same_as_yaml("{\n"
+                       "  \"one\": [1, \"two\", null, false],\n"
+                       "  \"empty\": [],\n"
+                       "  \"sub\": {\n"
+                       "    \"val\": -2,\n"
+                       "    \"deeper\": {\"list\": [\"a\", \"b\"]},\n"
+                       "    \"nothing\": {}\n"
+                       "  },\n"
+                       "  \"servers\": [{\"name\": \"first\", \"ports\": [1, 2]}, [3, 4], 5],\n"
+                       "  \"dup\": 1,\n"
+                       "  \"dup\": 2\n"
+                       "}\n");
+    check_same_as_yaml("{\"escaped\": \"a\\\"b\\\\c\\/d\\n\\u00e9\", \"key \\\"quoted\\\"\": \"x\"}");
+    check_same_as_yaml("[1, 2, {\"in\": 3}]");
+    check_same_as_yaml("");
+
+    // yaml-cpp does not read the surrogate pairs
+    auto output = CLI::ConfigJSON().from_config(Stream{"{\"smiley\": \"\\ud83d\\ude00\"}"});
+    REQUIRE(output.size() == 1u);
+    CHECK(output[0].inputs.at(0) == "\xf0\x9f\x98\x80");
+}
+
+TEST_CASE("Json: StringBased: Errors", "[config]")
+{
+    for (const std::string document: {"{\"one\": }", "{\"one\" 1}", "{\"one\": 1,}", "{one: 1}", "{\"one\": 01}",
+                 "{\"one\": 1} 2", "{\"one\": \"a", "{\"one\": \"\\x\"}", "[1, 2", "{\"one\": tru}"}) {
+        CAPTURE(document);
+        CHECK_THROWS_AS(CLI::ConfigJSON().from_config(Stream{document}), CLI::ConfigError);
+    }
+
+    try {
+        CLI::ConfigJSON().from_config(Stream{"{\n  \"one\": 1,\n  \"two\" 2\n}"});
+        FAIL("no error");
+    }
+    catch (const CLI::ConfigError& e) {
+        CHECK_THAT(e.what(), Catch::Matchers::ContainsSubstring("line 3, column 9"));
+    }
+}
+
+TEST_CASE("Json: StringBased: DeepNesting", "[config]")
+{
+    // the nested values are read in a loop, a deep document does not overflow the stack
+    std::size_t depth = 1000000;
+    std::string document = "{\"a\": " + std::string(depth, '[') + "1" + std::string(depth, ']') + "}";
+    auto output = CLI::ConfigJSON().from_config(Stream{document});
+    REQUIRE(output.size() == depth);
+    CHECK(output.front().fullname() == "a");
+    CHECK(output.front().inputs == std::vector<std::string>{"1"});
+
+    std::string unterminated = "{\"a\": " + std::string(depth, '[') + "1";
+    CHECK_THROWS_AS(CLI::ConfigJSON().from_config(Stream{unterminated}), CLI::ConfigError);
+    CHECK_THROWS_AS(CLI::ConfigJSON().from_config(Stream{unterminated + "}"}), CLI::ConfigError);
+}
+
+TEST_CASE_METHOD(TApp, "JsonSubcommands", "[config]")
+{
+    TempFile tmpJson{"TestJsonTmp.json"};
+
+    app.set_config("--config", tmpJson);
+    app.config_formatter(std::make_shared<CLI::ConfigJSON>());
+
+    {
+        std::ofstream out{tmpJson};
+        out << "{" << std::endl;
+        out << "  \"val\": 1," << std::endl;
+        out << "  \"flag\": true," << std::endl;
+        out << "  \"list\": [1, 2, 3]," << std::endl;
+        out << "  \"subcom\": {\"val\": 2, \"name\": \"text\"}" << std::endl;
+        out << "}" << std::endl;
+    }
+
+    int one{0}, two{0};
+    bool flag{false};
+    std::vector<int> list;
+    std::string name;
+    app.add_option("--val", one);
+    app.add_flag("--flag", flag);
+    app.add_option("--list", list);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+    subcom->add_option("--name", name);
+
+    run();
+
+    CHECK(one == 1);
+    CHECK(flag);
+    CHECK(list == std::vector<int>{1, 2, 3});
+    CHECK(two == 2);
+    CHECK(name == "text");
+}
+
+TEST_CASE_METHOD(TApp, "JsonOutputRoundTrip", "[config]")
+{
+    int one{1};
+    std::string text{"quoted \"text\""};
+    std::vector<double> values{1.5, 2.0};
+    app.add_option("--one", one)->capture_default_str();
+    app.add_option("--text", text)->capture_default_str();
+    app.add_option("--values", values)->capture_default_str();
+    auto* subcom = app.add_subcommand("subcom");
+    int two{2};
+    subcom->add_option("--two", two)->capture_default_str();
+    app.config_formatter(std::make_shared<CLI::ConfigJSON>());
+
+    args = {"--one", "5", "subcom", "--two", "6"};
+    run();
+
+    std::string json = app.config_to_str(true, true);
+    CHECK_THAT(json, Catch::Matchers::ContainsSubstring("\"one\": 5"));
+    CHECK_THAT(json, Catch::Matchers::ContainsSubstring("\"text\": \"quoted \\\"text\\\"\""));
+
+    auto items = CLI::ConfigJSON().from_config(Stream{json});
+    auto yaml = CLI::ConfigYAML().from_config(Stream{json});
+    REQUIRE(items.size() == yaml.size());
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        CHECK(items[i].fullname() == yaml[i].fullname());
+        CHECK(items[i].inputs == yaml[i].inputs);
+    }
+
+    TempFile tmpJson{"TestJsonTmp.json"};
+    {
+        std::ofstream out{tmpJson};
+        out << json;
+    }
+    one = two = 0;
+    text.clear();
+    values.clear();
+    app.set_config("--config", tmpJson);
+    args = {"subcom"};
+    run();
+    CHECK(one == 5);
+    CHECK(text == "quoted \"text\"");
+    CHECK(values == std::vector<double>{1.5, 2.0});
+    CHECK(two == 6);
+}
@@ -9,6 +9,9 @@
 #include <cli11-yaml/cli11-yaml.hpp>
 
 #include <cstdio>
+#include <filesystem>
+#include <map>
+#include <set>
 #include <sstream>
 
 using Catch::Matchers::ContainsSubstring;
@@ -411,6 +414,1274 @@ TEST_CASE("Yaml: StringBased: file_error", "[config]")
     CHECK_THROWS_AS(CLI::ConfigYAML().from_file("nonexist_file"), CLI::FileError);
 }
 
+TEST_CASE("Yaml: StringBased: file_mapped", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    std::string document = "one: three\n"
+                           "other:\n"
+                           "  two: [four, five]\n";
+    {
+        std::ofstream out{tmpYaml};
+        out << document;
+    }
+
+    auto output = CLI::ConfigYAML().from_file(tmpYaml);
+    CHECK(output == CLI::ConfigYAML().from_config(Stream{document}));
+    CHECK(output == CLI::ConfigYAML().from_buffer(document.data(), document.size()));
+    CHECK(output.size() == 4u);
+
+    {
+        std::ofstream out{tmpYaml};
+    }
+    CHECK(CLI::ConfigYAML().from_file(tmpYaml).empty());
+}
+
+TEST_CASE("Yaml: StringBased: file_cached", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    std::string cacheDirectory = "TestYamlCache";
+    std::filesystem::remove_all(cacheDirectory);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "one: three\n"
+               "other:\n"
+               "  two: [four, five]\n";
+    }
+
+    CLI::ConfigYAML yaml;
+    yaml.cache(cacheDirectory);
+
+    auto output = yaml.from_file(tmpYaml);
+    CHECK(output == CLI::ConfigYAML().from_file(tmpYaml));
+    REQUIRE(std::filesystem::exists(cacheDirectory));
+    std::vector<std::filesystem::path> entries{std::filesystem::directory_iterator{cacheDirectory}, {}};
+    REQUIRE(entries.size() == 1u);
+
+    // loaded from the cache
+    CHECK(yaml.from_file(tmpYaml) == output);
+
+    // same size, different content
+    {
+        std::ofstream out{tmpYaml};
+        out << "one: thrEE\n"
+               "other:\n"
+               "  two: [four, five]\n";
+    }
+    auto changed = yaml.from_file(tmpYaml);
+    CHECK(changed == CLI::ConfigYAML().from_file(tmpYaml));
+    CHECK(changed.front().inputs.at(0) == "thrEE");
+
+    // a corrupted cache is parsed again and rewritten
+    {
+        std::ofstream out{entries.front(), std::ios::binary | std::ios::trunc};
+        out << "CLIYCAC1 garbage";
+    }
+    CHECK(yaml.from_file(tmpYaml) == changed);
+    CHECK(yaml.from_file(tmpYaml) == changed);
+    CHECK(std::filesystem::file_size(entries.front()) > 16u);
+
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+TEST_CASE("Yaml: Streaming: SameAsNode", "[config]")
+{
+    std::vector<std::string> documents = {
+        "one: three\n"
+        "two: four\n",
+
+        "one: [three]\n"
+        "five:\n"
+        "  - six\n"
+        "  - and\n"
+        "  - seven\n",
+
+        "simple: true\n\n"
+        "other:\n"
+        "  sub2:\n"
+        "    sub-level2:\n"
+        "      sub-level3:\n"
+        "        absolute_newest: true\n"
+        "      still_newer: true\n"
+        "    newest: true\n",
+
+        "other:\n"
+        "  sub2:\n"
+        "other:\n"
+        "  sub3:\n"
+        "    empty: {}\n"
+        "    none: ~\n"
+        "    absolute_newest: true\n",
+
+        "servers:\n"
+        "  - name: first\n"
+        "    ports: [1, 2]\n"
+        "  - [3, 4]\n"
+        "  - 5\n",
+
+        "- one\n"
+        "- two\n",
+
+        "just a scalar\n",
+
+        "",
+    };
+
+    for (const auto& document: documents) {
+        auto outputNode = CLI::ConfigYAML().from_config(Stream{document});
+        auto outputStreaming = CLI::ConfigYAML().streaming()->from_config(Stream{document});
+
+        CHECK(outputNode == outputStreaming);
+    }
+}
+
+TEST_CASE("Yaml: Streaming: Aliases", "[config]")
+{
+    std::string document =
+        "defaults: &defaults\n"
+        "  pool: &pool [1, 2]\n"
+        "  timeout: 3\n"
+        "first: *defaults\n"
+        "second:\n"
+        "  pool: *pool\n";
+
+    auto outputNode = CLI::ConfigYAML().from_config(Stream{document});
+    auto outputStreaming = CLI::ConfigYAML().streaming()->from_config(Stream{document});
+
+    CHECK(outputNode == outputStreaming);
+}
+
+TEST_CASE("Yaml: Documents: Overlay", "[config]")
+{
+    std::string document =
+        "one: base\n"
+        "two: base\n"
+        "list: [1, 2, 3]\n"
+        "sub:\n"
+        "  three: base\n"
+        "  four: base\n"
+        "replaced:\n"
+        "  five: base\n"
+        "---\n"
+        "two: override\n"
+        "list: [4]\n"
+        "sub:\n"
+        "  four: override\n"
+        "  six: override\n"
+        "replaced: value\n"
+        "---\n";
+
+    auto output = CLI::ConfigYAML().from_config(Stream{document});
+
+    std::vector<CLI::ConfigItem> expected = {
+        {{}, "two", {"override"}},
+        {{}, "list", {"4"}},
+        {{"sub"}, "++", {}},
+        {{"sub"}, "four", {"override"}},
+        {{"sub"}, "six", {"override"}},
+        {{"sub"}, "--", {}},
+        {{}, "replaced", {"value"}},
+        {{}, "one", {"base"}},
+        {{"sub"}, "three", {"base"}},
+    };
+    CHECK(output == expected);
+    CHECK(CLI::ConfigYAML().streaming()->from_config(Stream{document}) == expected);
+}
+
+TEST_CASE("Yaml: Documents: SameAsNode", "[config]")
+{
+    std::vector<std::string> documents = {
+        // the maps of a sequence do not shadow the sequence itself
+        "a: 1\n"
+        "---\n"
+        "seq:\n"
+        "  - a: b\n"
+        "  - x\n",
+
+        "seq: 1\n"
+        "---\n"
+        "seq:\n"
+        "  - a: b\n"
+        "  - a: c\n"
+        "  - x\n",
+
+        "seq:\n"
+        "  - a: 0\n"
+        "---\n"
+        "seq:\n"
+        "  - a: {b: 1}\n"
+        "  - a: {c: 2}\n",
+
+        // a sequence is a value, shadowed with its maps by a later section
+        "s:\n"
+        "  t: 1\n"
+        "---\n"
+        "s:\n"
+        "  - t: 2\n"
+        "  - 3\n"
+        "---\n"
+        "s:\n"
+        "  u: 4\n",
+
+        "sub:\n"
+        "  val: 1\n"
+        "  deep:\n"
+        "    val: 2\n"
+        "---\n"
+        "sub:\n"
+        "  deep: 3\n"
+        "---\n"
+        "sub:\n"
+        "  other: 4\n",
+    };
+
+    for (const auto& document: documents) {
+        CAPTURE(document);
+        auto outputNode = CLI::ConfigYAML().from_config(Stream{document});
+        auto outputStreaming = CLI::ConfigYAML().streaming()->from_config(Stream{document});
+
+        CHECK(outputNode == outputStreaming);
+    }
+
+    std::vector<CLI::ConfigItem> expected = {
+        {{"seq"}, "a", {"b"}},
+        {{}, "seq", {"x"}},
+        {{}, "a", {"1"}},
+    };
+    CHECK(CLI::ConfigYAML().streaming()->from_config(Stream{documents.front()}) == expected);
+}
+
+TEST_CASE("Yaml: Compact: SameAsItems", "[config]")
+{
+    std::vector<std::string> documents = {
+        "val: 1\n"
+        "vals: [1, 2]\n"
+        "sub:\n"
+        "  val: 2\n"
+        "  deep:\n"
+        "    val: 3\n"
+        "    list:\n"
+        "      - a\n"
+        "      - inner: 4\n"
+        "      - b\n"
+        "  empty: {}\n"
+        "other:\n"
+        "  val: 5\n",
+        "one: base\n"
+        "sub:\n"
+        "  two: base\n"
+        "---\n"
+        "sub:\n"
+        "  two: override\n",
+    };
+
+    for (const auto& document: documents) {
+        auto expected = CLI::ConfigYAML().from_config(Stream{document});
+        CLI::CompactConfig compact = CLI::ConfigYAML().from_config_compact(Stream{document});
+        CHECK(compact.to_items() == expected);
+        CHECK(CLI::ConfigYAML().streaming()->from_config_compact(Stream{document}).to_items() == expected);
+    }
+
+    // the items of a section share its path
+    CLI::CompactConfig compact = CLI::ConfigYAML().from_config_compact(Stream{documents.front()});
+    std::set<CLI::CompactConfig::path_id> paths;
+    for (const auto& item: compact.items()) {
+        paths.insert(item.path);
+    }
+    CHECK(paths.size() == 5u);
+    CHECK(compact.path_count() >= paths.size());
+}
+
+TEST_CASE("Yaml: Compact: Aliases", "[config]")
+{
+    std::string document =
+        "defaults: &defaults\n"
+        "  timeout: 3\n"
+        "  pool: [1, 2]\n"
+        "  nested: &nested\n"
+        "    name: text\n"
+        "    empty: {}\n"
+        "first: *defaults\n"
+        "second:\n"
+        "  sub: *defaults\n"
+        "  again: *nested\n"
+        "list:\n"
+        "  - *nested\n"
+        "  - *defaults\n"
+        "first_again: *defaults\n";
+
+    auto expected = CLI::ConfigYAML().from_config(Stream{document});
+    CLI::CompactConfig compact = CLI::ConfigYAML().from_config_compact(Stream{document});
+    CHECK(compact.to_items() == expected);
+    CHECK(CLI::ConfigYAML().streaming()->from_config_compact(Stream{document}).to_items() == expected);
+
+    // the items of the aliases share the names and the inputs of the anchored map
+    std::map<std::string, std::set<const char*>> strings;
+    for (const auto& item: compact.items()) {
+        strings[std::string{item.name}].insert(item.name.data());
+        for (std::uint32_t i = 0; i < item.input_count; ++i) {
+            auto input = compact.inputs(item)[i];
+            strings[std::string{input}].insert(input.data());
+        }
+    }
+    CHECK(strings["timeout"].size() == 1u);
+    CHECK(strings["3"].size() == 1u);
+    CHECK(strings["name"].size() == 1u);
+    CHECK(strings["text"].size() == 1u);
+}
+
+TEST_CASE_METHOD(TApp, "YamlCompactSubcommands", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: 2" << std::endl;
+        out << "  subsub:" << std::endl;
+        out << "    val: 3" << std::endl;
+    }
+
+    int one{0}, two{0}, three{0};
+    app.add_option("--val", one);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+    auto* subsub = subcom->add_subcommand("subsub");
+    subsub->add_option("--val", three);
+
+    run();
+
+    CHECK(one == 1);
+    CHECK(two == 2);
+    CHECK(three == 3);
+
+    // the values of a section without subcommand are extras
+    app.allow_config_extras(CLI::config_extras_mode::error);
+    {
+        std::ofstream out{tmpYaml, std::ios::app};
+        out << "unknown:" << std::endl;
+        out << "  val: 4" << std::endl;
+    }
+    CHECK_THROWS_AS(run(), CLI::ConfigError);
+}
+
+namespace {
+/// A YAML format changing the values it reads, its files must not be read by the compact path of ConfigYAML
+class ConfigYAMLRewrite : public CLI::ConfigYAML {
+public:
+    std::vector<CLI::ConfigItem> from_config(std::istream& is) const override
+    {
+        std::vector<CLI::ConfigItem> items = CLI::ConfigYAML::from_config(is);
+        for (auto& item: items) {
+            if (item.name == "val") {
+                item.inputs = {"42"};
+                item.value = CLI::ConfigValue{};
+            }
+        }
+        return items;
+    }
+};
+}
+
+TEST_CASE_METHOD(TApp, "YamlDerivedFromConfig", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    app.config_formatter(std::make_shared<ConfigYAMLRewrite>());
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+    }
+
+    int val{0};
+    app.add_option("--val", val);
+    run();
+    CHECK(val == 42);
+    CHECK(CLI::ConfigYAML().supports_compact());
+    CHECK(!ConfigYAMLRewrite().supports_compact());
+}
+
+TEST_CASE("Yaml: Values: Typed", "[config]")
+{
+    std::string document =
+        "integer: 12\n"
+        "negative: -3\n"
+        "octal: 010\n"
+        "huge: 123456789012345678901234567890\n"
+        "real: 1.25\n"
+        "exponent: -2e3\n"
+        "flag: true\n"
+        "off: False\n"
+        "text: hello\n"
+        "quoted: \"12\"\n"
+        "list: [1, 2]\n";
+
+    using value_type = CLI::ConfigValue::value_type;
+    for (bool streaming: {false, true}) {
+        auto output = CLI::ConfigYAML().streaming(streaming)->from_config(Stream{document});
+        REQUIRE(output.size() == 11u);
+        CHECK(output[0].value.type == value_type::integer);
+        CHECK(output[0].value.integer == 12);
+        CHECK(output[1].value.integer == -3);
+        // only the forms read the same by lexical_cast are typed
+        CHECK(output[2].value.type == value_type::string);
+        CHECK(output[3].value.type == value_type::string);
+        CHECK(output[4].value.type == value_type::real);
+        CHECK(output[4].value.real == 1.25);
+        CHECK(output[5].value.real == -2000.0);
+        CHECK(output[6].value.type == value_type::boolean);
+        CHECK(output[6].value.boolean);
+        CHECK(output[7].value.type == value_type::boolean);
+        CHECK_FALSE(output[7].value.boolean);
+        CHECK(output[8].value.type == value_type::string);
+        CHECK(output[9].value.type == value_type::string);
+        CHECK(output[10].value.type == value_type::none);
+    }
+}
+
+TEST_CASE_METHOD(TApp, "YamlTypedValues", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "integer: 12" << std::endl;
+        out << "octal: 010" << std::endl;
+        out << "unsigned: -1" << std::endl;
+        out << "real: 1.5" << std::endl;
+        out << "whole: 3" << std::endl;
+        out << "single: 0.1" << std::endl;
+        out << "flag: true" << std::endl;
+        out << "text: \"12\"" << std::endl;
+    }
+
+    int integer{0}, octal{0};
+    unsigned int positive{0};
+    double real{0.0}, whole{0.0};
+    float single{0.0F};
+    bool flag{false};
+    std::string text;
+    app.add_option("--integer", integer);
+    app.add_option("--octal", octal);
+    app.add_option("--unsigned", positive);
+    app.add_option("--real", real);
+    app.add_option("--whole", whole);
+    app.add_option("--single", single);
+    app.add_option("--flag", flag)->expected(1);
+    app.add_option("--text", text);
+
+    // a negative value for an unsigned variable is still reported by the conversion
+    CHECK_THROWS_AS(run(), CLI::ConversionError);
+
+    app.remove_option(app.get_option("--unsigned"));
+    run();
+
+    CHECK(integer == 12);
+    CHECK(octal == 8);
+    CHECK(real == 1.5);
+    CHECK(whole == 3.0);
+    CHECK(single == 0.1F);
+    CHECK(flag);
+    CHECK(text == "12");
+}
+
+TEST_CASE_METHOD(TApp, "YamlDecodeMode", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "real: 2.5" << std::endl;
+        out << "vals: [1, 2, 3]" << std::endl;
+        out << "flag: true" << std::endl;
+        out << "name: \"text\"" << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: 2" << std::endl;
+        out << "  checked: 12" << std::endl;
+        out << "  subsub:" << std::endl;
+        out << "    val: 3" << std::endl;
+        out << "empty:" << std::endl;
+        out << "  nested: {}" << std::endl;
+    }
+
+    for (bool decode: {false, true}) {
+        CLI::App app{"decode"};
+        auto yaml = std::make_shared<CLI::ConfigYAML>();
+        yaml->decode(decode);
+        CHECK(yaml->supports_decode() == decode);
+        app.config_formatter(yaml);
+        app.set_config("--config", tmpYaml);
+
+        int one{0}, two{0}, three{0}, checked{0};
+        double real{0.0};
+        std::vector<int> vals;
+        bool flag{false};
+        std::string name;
+        app.add_option("--val", one)->required();
+        app.add_option("--real", real);
+        app.add_option("--vals", vals);
+        app.add_flag("--flag", flag);
+        app.add_option("--name", name);
+        auto* subcom = app.add_subcommand("subcom");
+        subcom->configurable();
+        subcom->add_option("--val", two);
+        subcom->add_option("--checked", checked)->check(CLI::Range(10, 20));
+        auto* subsub = subcom->add_subcommand("subsub");
+        subsub->add_option("--val", three);
+        int callbacks{0};
+        subcom->callback([&callbacks]() { ++callbacks; });
+
+        app.parse(std::vector<std::string>{"4.5", "--real"});
+
+        CHECK(one == 1);
+        CHECK(app.get_option("--val")->count() == 1u);
+        // the command line has precedence
+        CHECK(real == 4.5);
+        CHECK(vals == std::vector<int>({1, 2, 3}));
+        CHECK(flag);
+        CHECK(name == "text");
+        CHECK(two == 2);
+        CHECK(checked == 12);
+        CHECK(three == 3);
+        CHECK(subcom->parsed());
+        CHECK(callbacks == 1);
+    }
+}
+
+TEST_CASE_METHOD(TApp, "YamlDecodeModeErrors", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->decode();
+    app.config_formatter(yaml);
+    app.allow_config_extras(CLI::config_extras_mode::error);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "other: 2" << std::endl;
+    }
+
+    int one{0};
+    app.add_option("--val", one);
+    CHECK_THROWS_AS(run(), CLI::ConfigError);
+    // the streaming handler and the cache hold items, the app then parses them
+    CHECK(!CLI::ConfigYAML().decode()->streaming()->supports_decode());
+    CHECK(!CLI::ConfigYAML().decode()->cache("cache")->supports_decode());
+
+    // the decoder table follows the options added after a parse
+    int other{0};
+    app.add_option("--other", other);
+    run();
+    CHECK(one == 1);
+    CHECK(other == 2);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: text" << std::endl;
+    }
+    CHECK_THROWS_AS(run(), CLI::ConversionError);
+}
+
+TEST_CASE_METHOD(TApp, "YamlDecodeModeMovedOption", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->decode();
+    app.config_formatter(yaml);
+    app.allow_config_extras(CLI::config_extras_mode::error);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+    }
+
+    int one{0};
+    auto* opt = app.add_option("--val", one);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->configurable();
+    run();
+    CHECK(one == 1);
+
+    // the decoder table built by the first parse no longer sets the option at its old key
+    app._move_option(opt, subcom);
+    one = 0;
+    CHECK_THROWS_AS(run(), CLI::ConfigError);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "subcom:" << std::endl;
+        out << "  val: 2" << std::endl;
+    }
+    run();
+    CHECK(one == 2);
+}
+
+TEST_CASE("Yaml: Scanner: SameAsYamlCpp", "[config]")
+{
+    std::vector<std::string> documents = {
+        // in the subset of the scanner
+        "---\n"
+        "# comment\n"
+        "one: three   # comment\n"
+        "two : 'it''s'\n"
+        "real: 1.5\n"
+        "quoted: \"12\"\n"
+        "empty: ''\n"
+        "url: http://host:80/path#top\n"
+        "none: ~\n"
+        "nothing:\n"
+        "dup: 1\n"
+        "dup: 2\n"
+        "sub:\n"
+        "\n"
+        "  val: 4\n"
+        "  list:\n"
+        "  - a\n"
+        "  - ~\n"
+        "  - 'b c'\n"
+        "  deeper:\n"
+        "      list:\n"
+        "        - 1\n"
+        "        -\n"
+        "  empty_list:\n"
+        "  - null\n"
+        "other:\n"
+        "  sub:\n",
+        "  indented: 1\r\n"
+        "  root: 2\r\n",
+        "# only comments\n",
+        "",
+        // given to yaml-cpp
+        "one: [1, 2]\n",
+        "anchor: &a 1\n"
+        "alias: *a\n",
+        "tagged: !!str 12\n",
+        "block: |\n"
+        "  text\n",
+        "escaped: \"a\\tb\"\n",
+        "multi: line\n"
+        "  plain\n",
+        "list:\n"
+        "  - key: value\n",
+        "- top\n"
+        "- sequence\n",
+        "one: 1\n"
+        "---\n"
+        "one: 2\n",
+    };
+
+    for (const auto& document: documents) {
+        CAPTURE(document);
+        auto expected = CLI::ConfigYAML().scanner(false)->from_config(Stream{document});
+        auto output = CLI::ConfigYAML().from_config(Stream{document});
+        CHECK(output == expected);
+        REQUIRE(output.size() == expected.size());
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            CHECK(output[i].value.type == expected[i].value.type);
+        }
+        CHECK(CLI::ConfigYAML().from_config_compact(Stream{document}).to_items() == expected);
+    }
+
+    // the documents yaml-cpp rejects are not accepted by the scanner either
+    for (const std::string document: {"one: 1\n  two: 2\n", "one: 'a' b\n", "one:\n  - 1\n two: 2\n"}) {
+        CHECK_THROWS(CLI::ConfigYAML().from_config(Stream{document}));
+    }
+}
+
+TEST_CASE("Yaml: Parallel: SameAsSequential", "[config]")
+{
+    std::vector<std::string> documents = {
+        "---\n"
+        "# comment\n"
+        "one: 1\n"
+        "sub:\n"
+        "  val: 2\n"
+        "  list: [1, 2]\n"
+        "dup: 1\n"
+        "\"quoted key\": 3\n"
+        "dup: 2\n"
+        "empty:\n"
+        "last: 4",
+        // anchors used in their own block, or in another one
+        "defaults: &defaults\n"
+        "  timeout: 3\n"
+        "first:\n"
+        "  sub: &inner\n"
+        "    val: 1\n"
+        "  again: *inner\n",
+        "defaults: &defaults\n"
+        "  timeout: 3\n"
+        "first: *defaults\n",
+        // key lines inside multi-line scalars
+        "text: |\n"
+        "  not: a key\n"
+        "other: 1\n",
+        "flow: [1,\n"
+        "2]\n"
+        "other: 1\n",
+        "quoted: \"first\n"
+        "second: line\"\n"
+        "other: 1\n",
+        "plain: it's\n"
+        "other: \"a # b\" # 'comment\n"
+        "last: 2\n",
+        // not split
+        "one: 1\n"
+        "---\n"
+        "one: 2\n",
+        "- top\n"
+        "- sequence\n",
+        "  indented: 1\n"
+        "  root: 2\n",
+        "",
+    };
+
+    for (const auto& document: documents) {
+        CAPTURE(document);
+        for (bool scanner: {true, false}) {
+            auto expected = CLI::ConfigYAML().scanner(scanner)->from_config(Stream{document});
+            CLI::ConfigYAML yaml;
+            yaml.scanner(scanner)->parallel(4, 1);
+            CHECK(yaml.from_config(Stream{document}) == expected);
+            CHECK(yaml.from_config_compact(Stream{document}).to_items() == expected);
+        }
+    }
+
+    // the errors are the ones of the sequential conversion
+    for (const std::string document: {"one: 1\ntwo: [1, 2\nthree: 3\n", "one: 1\ntwo: 'a' b\nthree: 3\n"}) {
+        CAPTURE(document);
+        CHECK_THROWS(CLI::ConfigYAML().parallel(4, 1)->from_config(Stream{document}));
+    }
+}
+
+TEST_CASE("Yaml: Parallel: MappedFile", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    std::string document =
+        "one: 1\n"
+        "sub:\n"
+        "  val: 2\n"
+        "  list: [1, 2]\n"
+        "flow: {a: 1}\n"
+        "last: 4\n";
+    {
+        std::ofstream out{tmpYaml};
+        out << document;
+    }
+
+    // the scanner and the split read the mapped file in place, the items are the ones of the stream
+    auto expected = CLI::ConfigYAML().scanner(false)->from_config(Stream{document});
+    for (bool scanner: {true, false}) {
+        CLI::ConfigYAML yaml;
+        yaml.scanner(scanner)->parallel(4, 1);
+        CHECK(yaml.from_file(tmpYaml) == expected);
+        CHECK(yaml.from_file_compact(tmpYaml, {}).to_items() == expected);
+        CHECK(yaml.lazy()->from_file(tmpYaml, [](const std::string&) { return true; }) == expected);
+    }
+}
+
+TEST_CASE("Yaml: Limits: Rejected", "[config]")
+{
+    // the scanner, yaml-cpp, the streaming handler and the parallel conversion
+    auto configs = []() {
+        std::vector<CLI::ConfigYAML> yaml(4);
+        yaml[1].scanner(false);
+        yaml[2].streaming();
+        yaml[3].parallel(4, 1);
+        return yaml;
+    };
+    auto check = [](CLI::ConfigYAML& yaml, const std::string& document, bool rejected) {
+        CAPTURE(document);
+        if (rejected) {
+            CHECK_THROWS_AS(yaml.from_config(Stream{document}), CLI::ConfigError);
+            CHECK_THROWS_AS(yaml.from_config_compact(Stream{document}), CLI::ConfigError);
+        }
+        else {
+            CHECK(yaml.from_config(Stream{document}) == CLI::ConfigYAML().from_config(Stream{document}));
+        }
+    };
+
+    for (auto& yaml: configs()) {
+        yaml.maxDepth(3);
+        check(yaml, "one: 1\nsub:\n  deeper:\n    val: 1\n", false);
+        check(yaml, "one: 1\nsub:\n  deeper:\n    list:\n      - 1\n", true);
+        check(yaml, "one: 1\nsub: {deeper: {val: {val: 1}}}\n", true);
+        check(yaml, "nested: &nested {deeper: {val: 1}}\nsub:\n  val: *nested\n", true);
+    }
+    for (auto& yaml: configs()) {
+        // the root map is a value
+        yaml.maxItems(5);
+        check(yaml, "one: 1\ntwo: 2\nthree: 3\nfour: 4\n", false);
+        check(yaml, "one: 1\ntwo: 2\nthree: 3\nfour: 4\nfive: 5\n", true);
+        check(yaml, "one: [1, 2, 3, 4]\n", true);
+        check(yaml, "one: &a [1]\ntwo: *a\n", false);
+        check(yaml, "one: &a [1]\ntwo: *a\nthree: *a\n", true);
+    }
+    for (auto& yaml: configs()) {
+        // the aliases of aliases are counted as they are expanded
+        yaml.maxItems(1000);
+        check(yaml,
+                "a: &a [x, x, x, x, x, x, x, x, x, x]\n"
+                "b: &b [*a, *a, *a, *a, *a, *a, *a, *a, *a, *a]\n"
+                "c: &c {one: *b, two: *b, three: *b, four: *b, five: *b, six: *b, seven: *b, eight: *b, nine: *b}\n"
+                "d: [*c, *c, *c, *c, *c, *c, *c, *c, *c, *c]\n",
+                true);
+    }
+    for (auto& yaml: configs()) {
+        yaml.maxSequenceLength(3);
+        check(yaml, "one: [1, 2, 3]\ntwo:\n  - 1\n  - 2\n  - 3\n", false);
+        check(yaml, "one:\n  - 1\n  - 2\n  - 3\n  -\n", true);
+        check(yaml, "one: [1, 2, 3, 4]\n", true);
+    }
+    for (auto& yaml: configs()) {
+        yaml.maxScalarSize(4);
+        check(yaml, "one: four\ntwo: 'abcd'\n", false);
+        check(yaml, "one: fives\n", true);
+        check(yaml, "fives: 1\n", true);
+        check(yaml, "one: [1, \"fives\"]\n", true);
+    }
+
+    try {
+        CLI::ConfigYAML().maxDepth(2)->from_config(Stream{"one: 1\nsub:\n  deeper:\n    val: 1\n"});
+        FAIL("no error");
+    }
+    catch (const CLI::ConfigError& e) {
+        CHECK_THAT(e.what(), Catch::Matchers::ContainsSubstring("more nesting levels than 2 at line 3"));
+    }
+}
+
+TEST_CASE("Yaml: Limits: SameItems", "[config]")
+{
+    // not in the subset of the scanner, the limits are checked while the streaming handler builds the items
+    std::vector<std::string> documents = {
+        "one: [1, 2]\n"
+        "sub: {val: 2, deeper: {val: 3}}\n",
+        "anchor: &a\n"
+        "  val: 1\n"
+        "alias: *a\n",
+        "one: 1\n"
+        "sub:\n"
+        "  val: 1\n"
+        "---\n"
+        "sub:\n"
+        "  other: 2\n",
+        "tagged: !!str 12\n"
+        "block: |\n"
+        "  text\n",
+    };
+
+    for (const auto& document: documents) {
+        CAPTURE(document);
+        auto expected = CLI::ConfigYAML().from_config(Stream{document});
+        CLI::ConfigYAML yaml;
+        yaml.maxDepth(10)->maxItems(100);
+        CHECK(yaml.from_config(Stream{document}) == expected);
+        CHECK(yaml.from_config_compact(Stream{document}).to_items() == expected);
+        yaml.section("sub");
+        CHECK(yaml.from_config(Stream{document}) == CLI::ConfigYAML().section("sub")->from_config(Stream{document}));
+    }
+}
+
+TEST_CASE_METHOD(TApp, "YamlDecodeModeLimits", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->decode()->maxDepth(3);
+    app.config_formatter(yaml);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "vals: [2, 3]" << std::endl;
+        out << "subcom: {val: 4}" << std::endl;
+    }
+
+    int one{0}, two{0};
+    std::vector<int> vals;
+    app.add_option("--val", one);
+    app.add_option("--vals", vals);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->configurable();
+    subcom->add_option("--val", two);
+    run();
+    CHECK(one == 1);
+    CHECK(vals == std::vector<int>({2, 3}));
+    CHECK(two == 4);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "subcom: {val: {deeper: {val: 4}}}" << std::endl;
+    }
+    CHECK_THROWS_AS(run(), CLI::ConfigError);
+}
+
+TEST_CASE("Yaml: Limits: DeepDocument", "[config]")
+{
+    auto nested = [](std::size_t depth) {
+        std::string document;
+        for (std::size_t level = 0; level < depth; ++level) {
+            document += std::string(level, ' ') + "level:\n";
+        }
+        return document + std::string(depth, ' ') + "val: 1\n";
+    };
+
+    std::string document = nested(300);
+    CHECK(CLI::ConfigYAML().from_config(Stream{document})
+            == CLI::ConfigYAML().scanner(false)->from_config(Stream{document}));
+
+#ifndef CLI11_YAML_SCANNER_CHECK
+    // deeper than yaml-cpp goes, so not in the differential build: the scanner does not recurse per level
+    std::size_t depth = 1500;
+    document = nested(depth);
+    auto output = CLI::ConfigYAML().from_config(Stream{document});
+    REQUIRE(output.size() == 2 * depth + 1);
+    CHECK(output[depth].name == "val");
+    CHECK(output[depth].parents.size() == depth);
+    CHECK_THROWS_AS(CLI::ConfigYAML().maxDepth(1000)->from_config(Stream{document}), CLI::ConfigError);
+#endif
+}
+
+TEST_CASE("Yaml: Limits: Cached", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    std::string cacheDirectory = "TestYamlCache";
+    std::filesystem::remove_all(cacheDirectory);
+
+    {
+        std::ofstream out{tmpYaml};
+        for (int i = 0; i < 100; ++i) {
+            out << "key" << i << ": " << i << "\n";
+        }
+    }
+
+    CLI::ConfigYAML unlimited;
+    unlimited.cache(cacheDirectory);
+    REQUIRE(unlimited.from_file(tmpYaml).size() == 100u);
+    REQUIRE(std::filesystem::exists(cacheDirectory));
+
+    // the entry stored without limits is not used by a limited instance
+    CLI::ConfigYAML limited;
+    limited.cache(cacheDirectory)->maxItems(10);
+    CHECK_THROWS_AS(limited.from_file(tmpYaml), CLI::ConfigError);
+    CHECK_THROWS_AS(limited.from_file_compact(tmpYaml, {}), CLI::ConfigError);
+    CHECK(unlimited.from_file(tmpYaml).size() == 100u);
+
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+TEST_CASE_METHOD(TApp, "YamlLayeredDocuments", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "vals: [1, 2, 3]" << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: 2" << std::endl;
+        out << "  other: 5" << std::endl;
+        out << "---" << std::endl;
+        out << "vals: [4, 5]" << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: 3" << std::endl;
+    }
+
+    int one{0}, two{0}, other{0};
+    std::vector<int> vals;
+    app.add_option("--val", one);
+    app.add_option("--vals", vals);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+    subcom->add_option("--other", other);
+
+    run();
+
+    CHECK(one == 1);
+    CHECK(vals == std::vector<int>({4, 5}));
+    CHECK(two == 3);
+    CHECK(other == 5);
+}
+
+TEST_CASE("Yaml: Section: Selected", "[config]")
+{
+    std::string document =
+        "defaults: &defaults\n"
+        "  timeout: 3\n"
+        "val: 1\n"
+        "svc:\n"
+        "  db:\n"
+        "    val: 2\n"
+        "  api:\n"
+        "    val: 3\n"
+        "    vals: [4, 5]\n"
+        "    sub: *defaults\n"
+        "  workers:\n"
+        "    - val: 6\n"
+        "    - skipped\n"
+        "    - val: 7\n";
+
+    std::vector<CLI::ConfigItem> expected = {
+        {{}, "val", {"3"}},
+        {{}, "vals", {"4", "5"}},
+        {{"sub"}, "++", {}},
+        {{"sub"}, "timeout", {"3"}},
+        {{"sub"}, "--", {}},
+    };
+    CLI::ConfigYAML yaml;
+    yaml.section("svc.api");
+    CHECK(yaml.from_config(Stream{document}) == expected);
+    CHECK(yaml.streaming()->from_config(Stream{document}) == expected);
+
+    // the index counts all the elements of the sequence, not only the maps
+    yaml.section("svc.workers")->index(1);
+    CHECK(yaml.streaming(false)->from_config(Stream{document}).empty());
+    CHECK(yaml.streaming()->from_config(Stream{document}).empty());
+
+    yaml.index(2);
+    expected = {{{}, "val", {"7"}}};
+    CHECK(yaml.streaming(false)->from_config(Stream{document}) == expected);
+    CHECK(yaml.streaming()->from_config(Stream{document}) == expected);
+
+    yaml.index(-1);
+    expected = {{{}, "val", {"6"}}, {{}, "val", {"7"}}};
+    CHECK(yaml.streaming(false)->from_config(Stream{document}) == expected);
+    CHECK(yaml.streaming()->from_config(Stream{document}) == expected);
+
+    for (const auto* missing: {"svc.none", "val", "val.more", "svc.db.val", ""}) {
+        yaml.section(missing)->index(-1);
+        CHECK(yaml.streaming(false)->from_config(Stream{document})
+              == yaml.streaming()->from_config(Stream{document}));
+    }
+}
+
+TEST_CASE_METHOD(TApp, "YamlSection", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->section("svc.api");
+    app.config_formatter(yaml);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "svc:" << std::endl;
+        out << "  db:" << std::endl;
+        out << "    val: 2" << std::endl;
+        out << "  api:" << std::endl;
+        out << "    val: 3" << std::endl;
+        out << "    subcom:" << std::endl;
+        out << "      val: 4" << std::endl;
+    }
+
+    int val{0}, sub{0};
+    app.add_option("--val", val);
+    app.add_subcommand("subcom")->add_option("--val", sub);
+
+    run();
+
+    CHECK(3 == val);
+    CHECK(4 == sub);
+}
+
+TEST_CASE_METHOD(TApp, "YamlSectionNumber", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->section("config")->index(0);
+    app.config_formatter(yaml);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "config:" << std::endl;
+        out << "  - val: 2" << std::endl;
+        out << "  - val: 4" << std::endl;
+        out << "  - val: 6" << std::endl;
+    }
+
+    int val{0};
+    app.add_option("--val", val);
+
+    run();
+    CHECK(2 == val);
+
+    yaml->indexRef() = 1;
+    run();
+    CHECK(4 == val);
+
+    yaml->indexRef() = -1;
+    run();
+    // Take the first section in this case
+    CHECK(2 == val);
+
+    yaml->index(2)->streaming();
+    run();
+    CHECK(6 == val);
+}
+
+TEST_CASE_METHOD(TApp, "YamlLazySubcommands", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->lazy();
+    app.config_formatter(yaml);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "used:" << std::endl;
+        out << "  val: 2" << std::endl;
+        out << "unused:" << std::endl;
+        out << "  val: 3" << std::endl;
+        out << "triggered:" << std::endl;
+        out << "  val: 4" << std::endl;
+    }
+
+    int val{0}, used{0}, unused{0}, triggered{0};
+    app.add_option("--val", val);
+    auto* usedcom = app.add_subcommand("used");
+    usedcom->add_option("--val", used);
+    auto* unusedcom = app.add_subcommand("unused");
+    unusedcom->add_option("--val", unused);
+    auto* triggeredcom = app.add_subcommand("triggered");
+    triggeredcom->add_option("--val", triggered);
+    triggeredcom->configurable();
+
+    args = {"used"};
+
+    SECTION("node")
+    {
+    }
+    SECTION("streaming")
+    {
+        yaml->streaming();
+    }
+    SECTION("cached")
+    {
+        std::filesystem::remove_all("TestYamlCache");
+        yaml->cache("TestYamlCache");
+        run();
+        unused = 0;
+    }
+    run();
+
+    CHECK(val == 1);
+    CHECK(used == 2);
+    CHECK(unused == 0);
+    CHECK(triggered == 4);
+    CHECK(*triggeredcom);
+    CHECK(!*unusedcom);
+
+    yaml->lazy(false);
+    run();
+    CHECK(unused == 3);
+
+    std::filesystem::remove_all("TestYamlCache");
+}
+
+TEST_CASE_METHOD(TApp, "YamlLazyParallelRemovedSubcommand", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->lazy()->parallel(4, 1);
+    app.config_formatter(yaml);
+
+    {
+        std::ofstream out{tmpYaml};
+        for (int i = 0; i < 16; ++i) {
+            out << "sub" << i << ":" << std::endl;
+            out << "  val: " << i << std::endl;
+        }
+    }
+
+    std::vector<int> vals(16, -1);
+    for (int i = 0; i < 16; ++i) {
+        auto* sub = app.add_subcommand("sub" + std::to_string(i));
+        sub->add_option("--val", vals[static_cast<std::size_t>(i)]);
+        sub->configurable(i % 2 == 0);
+    }
+    auto* removed = app.add_subcommand("removed");
+    run();
+
+    // the subcommand names are looked up by the threads converting the sections, the index is not rebuilt by them
+    app.remove_subcommand(removed);
+    std::fill(vals.begin(), vals.end(), -1);
+    run();
+    for (int i = 0; i < 16; ++i) {
+        CHECK(vals[static_cast<std::size_t>(i)] == (i % 2 == 0 ? i : -1));
+    }
+}
+
+TEST_CASE_METHOD(TApp, "YamlOptionIndexFollowsChanges", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "first: 1" << std::endl;
+        out << "last: 3" << std::endl;
+        out << "sub:" << std::endl;
+        out << "  moved: 4" << std::endl;
+    }
+
+    int first{0}, removed{0}, last{0}, moved{0};
+    app.add_option("--first", first);
+    auto* removed_opt = app.add_option("--removed", removed);
+    app.add_option("--last", last)->envname("LAST_OLD");
+    auto* moved_opt = app.add_option("--moved", moved);
+    auto* sub = app.add_subcommand("sub");
+    sub->configurable();
+
+    // the positions of the options after the removed one are indexed again, the lookups only read the index
+    app.remove_option(removed_opt);
+    app._move_option(moved_opt, sub);
+    app.get_option("--last")->envname("LAST_NEW");
+    const CLI::App& const_app = app;
+    CHECK(const_app.get_option_no_throw("--removed") == nullptr);
+    CHECK(const_app.get_option_no_throw("--moved") == nullptr);
+    CHECK(const_app.get_option_no_throw("LAST_OLD") == nullptr);
+    REQUIRE(const_app.get_option_no_throw("LAST_NEW") != nullptr);
+    CHECK(const_app.get_option_no_throw("LAST_NEW")->get_name() == "--last");
+    CHECK(sub->get_option_no_throw("--moved") == moved_opt);
+
+    run();
+    CHECK(first == 1);
+    CHECK(last == 3);
+    CHECK(moved == 4);
+}
+
 TEST_CASE_METHOD(TApp, "YamlNotRequired", "[config]")
 {
     TempFile tmpYaml{"TestYamlTmp.yaml"};
@@ -614,6 +1885,50 @@ TEST_CASE_METHOD(TApp, "Yaml: MultiConfig", "[config]")
     CHECK(one == 55);
 }
 
+TEST_CASE_METHOD(TApp, "Yaml: MultiConfig_merged", "[config]")
+{
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+    TempFile tmpYaml2{"TestYamlTmp2.yaml"};
+
+    app.set_config("--config")->expected(1, 3);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    app.allow_config_extras(CLI::config_extras_mode::capture);
+    app.allow_extras();
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "two: 99" << std::endl;
+        out << "extra: 1" << std::endl;
+        out << "sub:" << std::endl;
+        out << "  three: 3" << std::endl;
+    }
+
+    {
+        std::ofstream out{tmpYaml2};
+        out << "two: 98" << std::endl;
+        out << "extra: 2" << std::endl;
+        out << "sub:" << std::endl;
+        out << "  three: 4" << std::endl;
+        out << "  four: 5" << std::endl;
+    }
+
+    int two{0}, three{0}, four{0};
+    app.add_option("--two", two);
+    auto* sub = app.add_subcommand("sub");
+    sub->configurable();
+    sub->add_option("--three", three);
+    sub->add_option("--four", four);
+
+    args = {"--config", tmpYaml2, "--config", tmpYaml};
+    run();
+
+    CHECK(two == 99);
+    CHECK(three == 3);
+    CHECK(four == 5);
+    // the key of the other file is skipped before being looked up, it is only captured once
+    CHECK(app.remaining() == std::vector<std::string>{"extra"});
+}
+
 TEST_CASE_METHOD(TApp, "Yaml: MultiConfig_single", "[config]")
 {
     TempFile tmpYaml{"TestYamlTmp.yaml"};
@@ -1012,6 +2327,117 @@ TEST_CASE_METHOD(TApp, "YamlLayered", "[config]")
     CHECK(!*subcom);
 }
 
+TEST_CASE_METHOD(TApp, "YamlLayeredStreaming", "[config]")
+{
+
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    app.set_config("--config", tmpYaml);
+    auto yaml = std::make_shared<CLI::ConfigYAML>();
+    yaml->streaming();
+    app.config_formatter(yaml);
+
+    {
+        std::ofstream out{tmpYaml};
+        out << "val: 1" << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: 2" << std::endl;
+        out << "  vals: [4, 5]" << std::endl;
+        out << "  subsubcom:" << std::endl;
+        out << "    val: 3" << std::endl;
+    }
+
+    int one{0}, two{0}, three{0};
+    std::vector<int> vals;
+    app.add_option("--val", one);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+    subcom->add_option("--vals", vals);
+    auto* subsubcom = subcom->add_subcommand("subsubcom");
+    subsubcom->add_option("--val", three);
+
+    run();
+
+    CHECK(one == 1);
+    CHECK(two == 2);
+    CHECK(three == 3);
+    CHECK(vals == std::vector<int>({4, 5}));
+
+    CHECK(0U == subcom->count());
+    CHECK(!*subcom);
+}
+
+TEST_CASE_METHOD(TApp, "YamlConfDirectory", "[config]")
+{
+    std::string confDirectory = "TestYamlConf.d";
+    std::filesystem::remove_all(confDirectory);
+    std::filesystem::create_directory(confDirectory);
+
+    for (int i = 0; i < 20; ++i) {
+        std::string name = confDirectory + "/" + (i < 10 ? "0" : "") + std::to_string(i) + "-fragment.yaml";
+        std::ofstream out{name};
+        out << "val" << i << ": " << i << std::endl;
+        out << "last: " << i << std::endl;
+        out << "subcom:" << std::endl;
+        out << "  val: " << i << std::endl;
+    }
+    {
+        std::ofstream out{confDirectory + "/.hidden.yaml"};
+        out << "last: 100" << std::endl;
+    }
+    {
+        std::ofstream out{confDirectory + "/99-notes.txt"};
+        out << "last: 99" << std::endl;
+    }
+
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    std::vector<int> vals(20, -1);
+    for (int i = 0; i < 20; ++i) {
+        app.add_option("--val" + std::to_string(i), vals[i]);
+    }
+    int last{0}, two{0};
+    app.add_option("--last", last);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+
+    SECTION("directory")
+    {
+        app.set_config("--config", confDirectory, "", true);
+        run();
+        CHECK(last == 99);
+        CHECK(two == 19);
+        for (int i = 0; i < 20; ++i) {
+            CHECK(vals[i] == i);
+        }
+    }
+    SECTION("glob")
+    {
+        app.set_config("--config", confDirectory + "/*.yaml", "", true);
+        run();
+        CHECK(last == 19);
+        CHECK(two == 19);
+        for (int i = 0; i < 20; ++i) {
+            CHECK(vals[i] == i);
+        }
+    }
+    SECTION("missing")
+    {
+        app.set_config("--config", "TestYamlNoConf.d/*.yaml", "", true);
+        CHECK_THROWS_AS(run(), CLI::FileError);
+    }
+    SECTION("parse error")
+    {
+        {
+            std::ofstream out{confDirectory + "/05-broken.yaml"};
+            out << "[broken: " << std::endl;
+        }
+        app.set_config("--config", confDirectory + "/*.yaml", "", true);
+        CHECK_THROWS_AS(run(), YAML::Exception);
+    }
+
+    std::filesystem::remove_all(confDirectory);
+}
+
 //TEST_CASE_METHOD(TApp, "YamlLayeredStream", "[config]")
 //{
 //
@@ -2883,3 +4309,164 @@ TEST_CASE_METHOD(TApp, "YamlLayered", "[config]")
 //    CHECK_THAT(str, ContainsSubstring("val1=\"I am a string\""));
 //    CHECK_THAT(str, ContainsSubstring("val2='I am a \"confusing\" string'"));
 //}
+
+/////// YAML output tests
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputSimple", "[config]")
+{
+
+    int v{0};
+    app.add_option("--simple", v);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    args = {"--simple=3"};
+
+    run();
+
+    std::string str = app.config_to_str();
+    CHECK(str == "simple: 3");
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputNoConfigurable", "[config]")
+{
+
+    int v1{0}, v2{0};
+    app.add_option("--simple", v1);
+    app.add_option("--noconf", v2)->configurable(false);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    args = {"--simple=3", "--noconf=2"};
+
+    run();
+
+    std::string str = app.config_to_str();
+    CHECK(str == "simple: 3");
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputDescriptions", "[config]")
+{
+    app.description("Some short app description.\n"
+                    "That has multiple lines.");
+    app.add_flag("--flagnr1", "First description.");
+    app.add_flag("--flagnr2", "Second description.")->group("group2");
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    run();
+
+    std::string str = app.config_to_str(true, true);
+    CHECK_THAT(str, ContainsSubstring("# Some short app description.\n# That has multiple lines.\n"));
+    CHECK_THAT(str, ContainsSubstring("flagnr1: false  # First description.\n"));
+    CHECK_THAT(str, ContainsSubstring("# group2 Options\n"));
+    CHECK_THAT(str, ContainsSubstring("flagnr2: false  # Second description."));
+    CHECK(str.find("flagnr1") < str.find("group2"));
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputVector", "[config]")
+{
+
+    std::vector<int> v;
+    app.add_option("--vector", v);
+    std::vector<int> d{4, 5};
+    app.add_option("--defaults", d)->capture_default_str();
+
+    args = {"--vector", "1", "2", "3"};
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    run();
+
+    std::string str = app.config_to_str();
+    CHECK(str == "vector:\n  - 1\n  - 2\n  - 3");
+
+    str = app.config_to_str(true);
+    CHECK_THAT(str, ContainsSubstring("defaults:\n  - 4\n  - 5"));
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputFlag", "[config]")
+{
+
+    int v{0}, q{0};
+    app.add_option("--simple", v);
+    app.add_flag("--nothing");
+    app.add_flag("--onething");
+    app.add_flag("--something", q);
+
+    args = {"--simple=3", "--onething", "--something", "--something"};
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    run();
+
+    std::string str = app.config_to_str();
+    CHECK_THAT(str, ContainsSubstring("simple: 3"));
+    CHECK_THAT(str, !ContainsSubstring("nothing"));
+    CHECK_THAT(str, ContainsSubstring("onething: true"));
+    CHECK_THAT(str, ContainsSubstring("something: 2"));
+
+    str = app.config_to_str(true);
+    CHECK_THAT(str, ContainsSubstring("nothing: false"));
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputQuoted", "[config]")
+{
+
+    std::string val1;
+    app.add_option("--val1", val1);
+    std::string val2;
+    app.add_option("--val2", val2);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    args = {"--val1", "I am a string", "--val2", "# not: a comment"};
+
+    run();
+
+    std::string str = app.config_to_str();
+    CHECK_THAT(str, ContainsSubstring("val1: I am a string"));
+    CHECK_THAT(str, ContainsSubstring("val2: \"# not: a comment\""));
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputSubcommands", "[config]")
+{
+
+    app.add_flag("--simple");
+    auto* subcom = app.add_subcommand("other");
+    subcom->add_flag("--newer");
+    auto* subsubcom = subcom->add_subcommand("sub2");
+    subsubcom->add_flag("--newest");
+    auto* unused = app.add_subcommand("unused");
+    unused->add_flag("--never");
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+    args = {"--simple", "other", "--newer", "sub2", "--newest"};
+    run();
+
+    std::string str = app.config_to_str();
+    CHECK(str == "simple: true\nother:\n  newer: true\n  sub2:\n    newest: true");
+}
+
+TEST_CASE_METHOD(TApp, "Yaml: OutputRoundTrip", "[config]")
+{
+
+    TempFile tmpYaml{"TestYamlTmp.yaml"};
+
+    int one{0}, two{0};
+    std::vector<std::string> vals;
+    bool flag{false};
+    app.add_option("--val", one);
+    app.add_flag("--flag", flag);
+    auto* subcom = app.add_subcommand("subcom");
+    subcom->add_option("--val", two);
+    subcom->add_option("--vals", vals);
+    app.config_formatter(std::make_shared<CLI::ConfigYAML>());
+
+    args = {"--val", "1", "--flag", "subcom", "--val", "2", "--vals", "a b", "c: d"};
+    run();
+
+    {
+        std::ofstream out{tmpYaml};
+        out << app.config_to_str(true, true);
+    }
+
+    one = two = 0;
+    flag = false;
+    vals.clear();
+    app.set_config("--config", tmpYaml);
+    args = {};
+    run();
+
+    CHECK(one == 1);
+    CHECK(flag);
+    CHECK(two == 2);
+    CHECK(vals == std::vector<std::string>{"a b", "c: d"});
+}